@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @addtogroup sdm_credential_provider Credential Provider
+ * @brief Lower-level API for access to secure debug credentials.
+ *
+ * The credential provider layer is used by secure debug protocol implementations, such as the PSA ADAC
+ * reference implementation, to find credentials and to sign challenges. It is internal to an SDM; it is not
+ * part of the interface between the SDM and the host.
+ *
+ * Credentials are held in a credential store. A store loads and decodes each credential once, and keeps the
+ * decoded form in memory. Stores are reference counted and shared by name within a process, so that all SDM
+ * instances that use the same credentials, for example all handles opened with the same resources directory,
+ * share one store and do not repeat file parsing or key loading.
+ *
+ * The source of credentials is pluggable. Backends can provide credentials from files, from a hardware token,
+ * from an HSM, or from any other source. A backend may sign asynchronously, so that signing on a remote or slow
+ * device does not block other work.
+ *
+ * Signing can be the largest CPU cost of authentication, particularly when many targets are unlocked at once.
+ * A store therefore runs asynchronous signing requests from all of its users on one worker pool, which can hand
+ * several requests to a backend together. For algorithms with message-independent signing work, such as the
+ * per-signature nonce and curve point of ECDSA, the SDM may also ask the store to do that work in advance with
+ * SDMCredentialPrepare(), typically while the challenge request is in flight.
+ *
+ * All functions in this layer are thread safe.
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines the credential provider layer.
+ */
+
+#ifndef _SDM_CREDENTIAL_PROVIDER_H_
+#define _SDM_CREDENTIAL_PROVIDER_H_
+
+#include "secure_debug_manager.h"
+
+//! @brief Opaque handle to a credential store.
+typedef struct _SDMCredentialStoreOpaque *SDMCredentialStore;
+
+//! @brief Opaque handle to a credential within a store.
+//!
+//! Credential handles remain valid until the store that contains them is released.
+typedef struct _SDMCredentialOpaque *SDMCredential;
+
+/*!
+ * @brief Signature algorithms.
+ */
+enum SDMSignatureAlgorithmEnum {
+    SDMSignatureAlgorithm_EcdsaP256Sha256 = 1,  //!< ECDSA with curve P-256 and SHA-256.
+    SDMSignatureAlgorithm_EcdsaP384Sha384 = 2,  //!< ECDSA with curve P-384 and SHA-384.
+    SDMSignatureAlgorithm_EcdsaP521Sha512 = 3,  //!< ECDSA with curve P-521 and SHA-512.
+    SDMSignatureAlgorithm_RsaPss3072Sha256 = 4, //!< RSA-PSS with a 3072-bit key and SHA-256.
+    SDMSignatureAlgorithm_RsaPss4096Sha256 = 5, //!< RSA-PSS with a 4096-bit key and SHA-256.
+    SDMSignatureAlgorithm_Ed25519 = 6,          //!< EdDSA with Ed25519.
+    SDMSignatureAlgorithm_Ed448 = 7,            //!< EdDSA with Ed448.
+    SDMSignatureAlgorithm_CmacAes = 8,          //!< AES-CMAC with a symmetric key.
+    SDMSignatureAlgorithm_HmacSha256 = 9,       //!< HMAC with SHA-256 and a symmetric key.
+};
+
+//! @brief Type for signature algorithm.
+typedef uint32_t SDMSignatureAlgorithm;
+
+/*!
+ * @brief Credential flags.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMCredentialInfo::flags field.
+ */
+enum SDMCredentialFlagsEnum {
+    SDMCredential_HasPrivateKey = (1 << 0),     //!< The credential can sign.
+    SDMCredential_HardwareKey = (1 << 1),       //!< The private key is held by a hardware token or HSM.
+    SDMCredential_NeedsUserInput = (1 << 2),    //!< Signing may require user input, such as a PIN.
+};
+
+/*!
+ * @brief Description of a credential.
+ *
+ * All pointers remain valid for the lifetime of the store that holds the credential.
+ */
+typedef struct SDMCredentialInfo {
+    const char *id;                     //!< Identifier unique within the store. Must be a valid C identifier.
+    const char *label;                  //!< UTF-8 display name, for instance for an #SDMForm_ItemSelect list.
+    SDMSignatureAlgorithm algorithm;    //!< Signature algorithm of the credential's key.
+    uint32_t flags;                     //!< Mask composed of #SDMCredentialFlagsEnum enums.
+    const uint8_t *publicKey;           //!< Encoded public key, in the format of the protocol. May be NULL.
+    size_t publicKeySize;               //!< Size in bytes of _publicKey_.
+    const uint8_t *certificateChain;    //!< Encoded certificate chain, in the format of the protocol. May be NULL.
+    size_t certificateChainSize;        //!< Size in bytes of _certificateChain_.
+} SDMCredentialInfo;
+
+/*!
+ * @brief Completion routine for asynchronous signing.
+ *
+ * Invoked exactly once for each signing request queued with SDMCredentialSignAsync(). May be invoked on any
+ * thread, and may be invoked before SDMCredentialSignAsync() returns.
+ *
+ * @param[in] result Result of the signing operation.
+ * @param[in] signatureSize Size in bytes of the signature written to the caller's buffer, if _result_ is
+ *      #SDMReturnCode_Success.
+ * @param[in] context The _completionContext_ value passed to SDMCredentialSignAsync().
+ */
+typedef void (*SDMSignCompletion)(SDMReturnCode result, size_t signatureSize, void *context);
+
+/*!
+ * @brief A signing request passed to SDMCredentialBackend::signBatch.
+ */
+typedef struct SDMSignRequest {
+    void *keyContext;               //!< Key context of the credential.
+    void *prepared;                 //!< Value from SDMCredentialBackend::prepare for this key, or NULL.
+    const uint8_t *message;         //!< Message to sign.
+    size_t messageSize;             //!< Size in bytes of the message.
+    uint8_t *signature;             //!< Buffer that receives the signature.
+    size_t signatureCapacity;       //!< Size in bytes of the signature buffer.
+    size_t signatureSize;           //!< Set by the backend to the size in bytes of the signature.
+    SDMReturnCode result;           //!< Set by the backend to the result of this request.
+} SDMSignRequest;
+
+/*!
+ * @brief Callback used by a backend to add a credential to a store.
+ *
+ * @param[in] info Description of the credential. The store copies the description and the data it points to.
+ * @param[in] keyContext Backend-defined value passed to the backend's key functions for this credential.
+ * @param[in] storeContext The _storeContext_ value passed to SDMCredentialBackend::enumerate.
+ */
+typedef SDMReturnCode (*SDMCredentialAddFn)(const SDMCredentialInfo *info, void *keyContext, void *storeContext);
+
+/*!
+ * @brief Credential backend interface.
+ *
+ * A backend provides credentials to a store. The store calls the backend's functions with the
+ * _backendContext_ value passed to SDMCredentialStoreAddBackend(). The store serializes calls to _enumerate_
+ * and _close_, but may call _sign_ and _signAsync_ concurrently.
+ */
+typedef struct SDMCredentialBackend {
+    //! Name of the backend, for diagnostics. Must not be NULL.
+    const char *name;
+
+    /*!
+     * @brief Report the backend's credentials.
+     *
+     * Called once, when the backend is added to a store. The backend calls _add_ once per credential.
+     */
+    SDMReturnCode (*enumerate)(void *backendContext, SDMCredentialAddFn add, void *storeContext);
+
+    /*!
+     * @brief Sign a message.
+     *
+     * The backend applies the hash, if any, that the credential's algorithm requires.
+     */
+    SDMReturnCode (*sign)(
+        void *backendContext,
+        void *keyContext,
+        const uint8_t *message,
+        size_t messageSize,
+        uint8_t *signature,
+        size_t signatureCapacity,
+        size_t *signatureSize);
+
+    /*!
+     * @brief Queue the signing of a message. Optional; may be NULL.
+     *
+     * Same as _sign_, except that the result is reported through the completion routine. If this is NULL, the
+     * store performs asynchronous requests by calling _sign_ on a store-owned thread.
+     */
+    SDMReturnCode (*signAsync)(
+        void *backendContext,
+        void *keyContext,
+        const uint8_t *message,
+        size_t messageSize,
+        uint8_t *signature,
+        size_t signatureCapacity,
+        SDMSignCompletion completion,
+        void *completionContext);
+
+    //! @brief Release a key context. Called once per credential when the store is destroyed. May be NULL.
+    void (*releaseKey)(void *backendContext, void *keyContext);
+
+    //! @brief Release the backend. Called when the store is destroyed. May be NULL.
+    void (*close)(void *backendContext);
+
+    /*!
+     * @brief Sign several messages. Optional; may be NULL.
+     *
+     * Called on a worker thread of the store with requests collected from concurrent SDMCredentialSignAsync()
+     * calls, possibly for different keys of this backend. The backend sets the _result_ and _signatureSize_
+     * fields of each request, and may share work between requests, for instance a batched modular inversion.
+     * If this is NULL, the store calls _sign_ for each request.
+     *
+     * @retval SDMReturnCode_Success The results were set in the requests.
+     * @return Otherwise, the error applies to all requests.
+     */
+    SDMReturnCode (*signBatch)(void *backendContext, SDMSignRequest *requests, size_t count);
+
+    /*!
+     * @brief Do the message-independent part of one signature in advance. Optional; may be NULL.
+     *
+     * For ECDSA, this is the generation of the nonce _k_ and the computation of _k_*G and _k_^-1. The value
+     * returned in _prepared_ is passed to exactly one of _signPrepared_, _signBatch_, or _discardPrepared_,
+     * and must never be used for more than one signature.
+     */
+    SDMReturnCode (*prepare)(void *backendContext, void *keyContext, void **prepared);
+
+    /*!
+     * @brief Sign a message using a value from _prepare_. Must be provided if _prepare_ is provided.
+     *
+     * Consumes _prepared_, whether or not signing succeeds.
+     */
+    SDMReturnCode (*signPrepared)(
+        void *backendContext,
+        void *keyContext,
+        void *prepared,
+        const uint8_t *message,
+        size_t messageSize,
+        uint8_t *signature,
+        size_t signatureCapacity,
+        size_t *signatureSize);
+
+    //! @brief Destroy an unused value from _prepare_. Must be provided if _prepare_ is provided.
+    void (*discardPrepared)(void *backendContext, void *keyContext, void *prepared);
+} SDMCredentialBackend;
+
+/*!
+ * @brief Flags for SDMCredentialStoreAddDirectory().
+ */
+enum SDMCredentialDirectoryFlagsEnum {
+    SDMCredentialDirectory_Recursive = (1 << 0),    //!< Also load credentials from subdirectories.
+};
+
+/*!
+ * @brief Signing worker pool settings of a store.
+ *
+ * Zero in any field other than _batchWindowUs_ selects the store's default for that field. Zero in
+ * _batchWindowUs_ means that a worker does not wait for further requests.
+ */
+typedef struct SDMCredentialStoreConfig {
+    uint32_t workerThreads;         //!< Number of signing worker threads. The default is the number of CPUs.
+    uint32_t maxBatchSize;          //!< Maximum number of requests passed to one SDMCredentialBackend::signBatch call.
+    uint32_t batchWindowUs;         //!< Time a worker waits for further requests before signing a partial batch.
+    uint32_t maxPreparedPerCredential; //!< Maximum number of prepared signatures held per credential.
+} SDMCredentialStoreConfig;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @name Credential store
+//@{
+/*!
+ * @brief Obtain a shared credential store.
+ *
+ * Returns the store with the given name, creating an empty store if none exists in the process. Each
+ * successful call must be balanced by a call to SDMCredentialStoreRelease(). It is recommended to name stores
+ * after the SDM's resources directory path.
+ *
+ * @param[in] name Name of the store. Must not be NULL.
+ * @param[out] store Set to the store handle on success.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_InternalError
+ */
+SDMReturnCode SDMCredentialStoreAcquire(const char *name, SDMCredentialStore *store);
+
+/*!
+ * @brief Release a reference to a credential store.
+ *
+ * The store is destroyed, and its backends closed, when the last reference is released.
+ *
+ * @param[in] store Store handle.
+ */
+void SDMCredentialStoreRelease(SDMCredentialStore store);
+
+/*!
+ * @brief Load credentials from files in a directory.
+ *
+ * Each file is read and decoded once. Calling this again with the same path has no effect, so each SDM
+ * instance may call it without checking whether another instance already has. Files which are not
+ * recognised as credentials are ignored.
+ *
+ * @param[in] store Store handle.
+ * @param[in] path Absolute path of the directory.
+ * @param[in] flags Mask composed of #SDMCredentialDirectoryFlagsEnum enums.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_RequestFailed The directory could not be read.
+ */
+SDMReturnCode SDMCredentialStoreAddDirectory(SDMCredentialStore store, const char *path, uint32_t flags);
+
+/*!
+ * @brief Add a credential backend to a store.
+ *
+ * The backend's _enumerate_ function is called before this function returns.
+ *
+ * @param[in] store Store handle.
+ * @param[in] backend Backend interface. Must remain valid for the lifetime of the store.
+ * @param[in] backendContext Backend-defined value passed to the backend's functions.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_RequestFailed The backend's _enumerate_ function failed.
+ */
+SDMReturnCode SDMCredentialStoreAddBackend(
+    SDMCredentialStore store,
+    const SDMCredentialBackend *backend,
+    void *backendContext);
+
+/*!
+ * @brief Get the number of credentials in a store.
+ *
+ * @param[in] store Store handle.
+ * @return Number of credentials.
+ */
+size_t SDMCredentialStoreCount(SDMCredentialStore store);
+
+/*!
+ * @brief Get a credential by index.
+ *
+ * @param[in] store Store handle.
+ * @param[in] index Index of the credential, less than SDMCredentialStoreCount().
+ * @param[out] credential Set to the credential handle on success.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ */
+SDMReturnCode SDMCredentialStoreGet(SDMCredentialStore store, size_t index, SDMCredential *credential);
+
+/*!
+ * @brief Find a credential by its identifier.
+ *
+ * @param[in] store Store handle.
+ * @param[in] id Credential identifier.
+ * @param[out] credential Set to the credential handle on success.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument No credential has this identifier.
+ */
+SDMReturnCode SDMCredentialStoreFind(SDMCredentialStore store, const char *id, SDMCredential *credential);
+
+/*!
+ * @brief Set the signing worker pool settings of a store.
+ *
+ * The settings apply to all users of the store; a later call replaces them. Requests already queued are not
+ * affected. A _batchWindowUs_ of zero means that a worker signs the requests that are queued when it becomes
+ * free, without waiting for more, so batching never adds latency to a lone request.
+ *
+ * @param[in] store Store handle.
+ * @param[in] config New settings.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_InternalError Worker threads could not be started.
+ */
+SDMReturnCode SDMCredentialStoreConfigure(SDMCredentialStore store, const SDMCredentialStoreConfig *config);
+//@}
+
+//! @name Credentials
+//@{
+/*!
+ * @brief Get the description of a credential.
+ *
+ * @param[in] credential Credential handle.
+ * @return Pointer to the description, valid for the lifetime of the store.
+ */
+const SDMCredentialInfo *SDMCredentialGetInfo(SDMCredential credential);
+
+/*!
+ * @brief Sign a message with a credential.
+ *
+ * @param[in] credential Credential handle. Must have #SDMCredential_HasPrivateKey set.
+ * @param[in] message Message to sign.
+ * @param[in] messageSize Size in bytes of the message.
+ * @param[out] signature Buffer that receives the signature.
+ * @param[in] signatureCapacity Size in bytes of the signature buffer.
+ * @param[out] signatureSize Set to the size in bytes of the signature.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_UnsupportedOperation The credential cannot sign.
+ * @retval SDMReturnCode_UserCancelled User input required by the backend was cancelled.
+ * @retval SDMReturnCode_RequestFailed
+ */
+SDMReturnCode SDMCredentialSign(
+    SDMCredential credential,
+    const uint8_t *message,
+    size_t messageSize,
+    uint8_t *signature,
+    size_t signatureCapacity,
+    size_t *signatureSize);
+
+/*!
+ * @brief Queue the signing of a message with a credential.
+ *
+ * Same as SDMCredentialSign(), except that this function does not wait for the signature. The message and
+ * signature buffers must remain valid until the completion routine is invoked. When this function returns
+ * #SDMReturnCode_Success, the completion routine will be invoked exactly once; otherwise it will not be invoked.
+ *
+ * @param[in] credential Credential handle. Must have #SDMCredential_HasPrivateKey set.
+ * @param[in] message Message to sign.
+ * @param[in] messageSize Size in bytes of the message.
+ * @param[out] signature Buffer that receives the signature.
+ * @param[in] signatureCapacity Size in bytes of the signature buffer.
+ * @param[in] completion Completion routine. Must not be NULL.
+ * @param[in] completionContext Value passed to the completion routine.
+ *
+ * @retval SDMReturnCode_Success The request was queued.
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_UnsupportedOperation The credential cannot sign.
+ */
+SDMReturnCode SDMCredentialSignAsync(
+    SDMCredential credential,
+    const uint8_t *message,
+    size_t messageSize,
+    uint8_t *signature,
+    size_t signatureCapacity,
+    SDMSignCompletion completion,
+    void *completionContext);
+
+/*!
+ * @brief Prepare signatures with a credential in advance.
+ *
+ * Queues the message-independent work for up to _count_ signatures on the store's worker pool, and returns
+ * without waiting for it. Later calls of SDMCredentialSign() and SDMCredentialSignAsync() with this credential
+ * use a prepared signature if one is ready. An SDM typically calls this just before it sends the request for
+ * the challenge, so that the work overlaps the round trip to the target.
+ *
+ * The store holds at most SDMCredentialStoreConfig::maxPreparedPerCredential prepared signatures per
+ * credential. Prepared signatures are held in memory only, are each used once, and are destroyed with
+ * the store.
+ *
+ * @param[in] credential Credential handle. Must have #SDMCredential_HasPrivateKey set.
+ * @param[in] count Number of signatures to prepare.
+ *
+ * @retval SDMReturnCode_Success The work was queued.
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_UnsupportedOperation The credential's backend does not support preparation, or the
+ *      algorithm has no message-independent work, as for EdDSA.
+ */
+SDMReturnCode SDMCredentialPrepare(SDMCredential credential, uint32_t count);
+//@}
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* _SDM_CREDENTIAL_PROVIDER_H_ */
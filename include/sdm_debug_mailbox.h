@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*!
+ * @addtogroup sdm_debug_mailbox Debug Mailbox Interface
+ * @brief Lower-level API for message transfer through a debug mailbox.
+ *
+ * The debug mailbox interface is used by secure debug protocol implementations, such as the PSA ADAC
+ * reference implementation, to exchange whole protocol messages with the target. It is internal to an SDM;
+ * it is not part of the interface between the SDM and the host.
+ *
+ * The interface has two layers:
+ *
+ * - A mailbox engine, #SDMMailbox, which is common to all mailboxes. The engine sends and receives whole
+ *   messages using the register access callbacks. It keeps status polling inside the batches it issues, and
+ *   keeps several batches in flight when the host supports it.
+ * - A transport, #SDMMailboxTransport, which describes one kind of mailbox. A transport encodes message bytes
+ *   into register operations and decodes received words into message bytes, including any framing. A
+ *   transport for the Arm SDC-600 Secure Debug Channel is provided by SDMMailboxTransportSDC600().
+ *
+ * The engine selects the register access callback as follows:
+ *
+ * - If #SDMOpenFlags_AsyncIO was set and #SDMCallbacks::registerAccessAsync is provided, up to
+ *   SDMMailboxParameters::maxBatchesInFlight batches are queued at once. The status polls of each batch
+ *   gate the data accesses that follow them, so ordering is kept by the batches themselves.
+ * - Otherwise, if #SDMCallbacks::registerAccessEx is provided, each batch is issued with gated block
+ *   operations (#SDMRegisterAccessFlag_Gated), so one callback moves many words.
+ * - Otherwise, #SDMCallbacks::registerAccess is used with interleaved #SDMRegisterAccessOp_Poll operations.
+ *
+ * Each mailbox must be used by one thread at a time.
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines the debug mailbox interface layer.
+ */
+
+#ifndef _SDM_DEBUG_MAILBOX_H_
+#define _SDM_DEBUG_MAILBOX_H_
+
+#include "secure_debug_manager.h"
+
+//! @brief Opaque handle to a mailbox engine.
+typedef struct _SDMMailboxOpaque *SDMMailbox;
+
+/*!
+ * @brief Destination for register operations built by a transport.
+ *
+ * The transport appends operations to _ops_ and increments _count_. It must not append more than
+ * _capacity_ operations. Values referenced by the operations must be stored in _values_, which holds
+ * _valueCapacity_ packed elements of the transport's transfer size, in host byte order; _valueCount_ is the
+ * number of elements used. Element _i_ starts at byte offset _i_ times the element size, so an
+ * SDMRegisterAccessEx::value that points into _values_ refers to an element, or for a block operation an
+ * array of elements, of the transfer size of the register access call. Both arrays are owned by the engine and
+ * remain valid until the batch completes.
+ */
+typedef struct SDMMailboxBatch {
+    SDMRegisterAccessEx *ops;   //!< Operation array.
+    size_t capacity;            //!< Number of elements in _ops_.
+    size_t count;               //!< Number of operations appended.
+    void *values;               //!< Value storage for the operations.
+    size_t valueCapacity;       //!< Number of elements in _values_.
+    size_t valueCount;          //!< Number of elements of _values_ used.
+} SDMMailboxBatch;
+
+/*!
+ * @brief Mailbox transport interface.
+ *
+ * All functions receive the _transportContext_ value from #SDMMailboxParameters. A transport only builds
+ * and interprets register operations; it never calls an SDM callback itself.
+ */
+typedef struct SDMMailboxTransport {
+    //! Name of the transport, for diagnostics. Must not be NULL.
+    const char *name;
+
+    //! Transfer size of the mailbox registers.
+    SDMTransferSize transferSize;
+
+    /*!
+     * @brief Append operations that establish the link with the target. May be NULL.
+     *
+     * Called by SDMMailboxConnect(). The engine issues the batch and then receives and passes any reply words
+     * to _decode_ until it reports a complete message, which for a link request is the link reply.
+     */
+    SDMReturnCode (*connect)(void *transportContext, SDMMailboxBatch *batch);
+
+    //! @brief Append operations that tear down the link with the target. May be NULL.
+    SDMReturnCode (*disconnect)(void *transportContext, SDMMailboxBatch *batch);
+
+    /*!
+     * @brief Append operations that send part of a message.
+     *
+     * Called repeatedly with increasing _offset_ until the whole message is consumed. The transport adds
+     * framing at the start and end of the message, and includes the status polls that gate each data write.
+     *
+     * @param[in] transportContext Transport context.
+     * @param[in] message The complete message.
+     * @param[in] messageSize Size in bytes of the message.
+     * @param[in] offset Offset of the first byte not yet consumed.
+     * @param[in,out] batch Batch to append to.
+     * @param[out] consumed Set to the number of message bytes consumed by the appended operations.
+     */
+    SDMReturnCode (*encode)(
+        void *transportContext,
+        const uint8_t *message,
+        size_t messageSize,
+        size_t offset,
+        SDMMailboxBatch *batch,
+        size_t *consumed);
+
+    /*!
+     * @brief Append operations that receive up to _maxWords_ words.
+     *
+     * The values read are passed to _decode_ in order once the batch completes.
+     */
+    SDMReturnCode (*receive)(void *transportContext, size_t maxWords, SDMMailboxBatch *batch);
+
+    /*!
+     * @brief Decode received words.
+     *
+     * Removes framing and appends message bytes to _message_. Words that follow the end of a message must be
+     * retained by the transport and returned by the next call.
+     *
+     * @param[in] transportContext Transport context.
+     * @param[in] words Received words, packed as elements of the transport's transfer size in host byte order.
+     * @param[in] wordCount Number of received words.
+     * @param[out] message Message buffer.
+     * @param[in] messageCapacity Size in bytes of the message buffer.
+     * @param[in,out] messageSize Number of bytes of the message buffer filled so far.
+     * @param[out] complete Set to true when the end of the message has been decoded.
+     *
+     * @retval SDMReturnCode_Success
+     * @retval SDMReturnCode_InvalidArgument The message buffer is too small.
+     * @retval SDMReturnCode_RequestFailed Framing error.
+     */
+    SDMReturnCode (*decode)(
+        void *transportContext,
+        const void *words,
+        size_t wordCount,
+        uint8_t *message,
+        size_t messageCapacity,
+        size_t *messageSize,
+        SDMBool *complete);
+
+    //! @brief Discard partially sent or received framing state. May be NULL.
+    void (*reset)(void *transportContext);
+} SDMMailboxTransport;
+
+/*!
+ * @brief Register layout of an SDC-600 COM-AP.
+ *
+ * Used as the transport context for SDMMailboxTransportSDC600(). Offsets are relative to the AP.
+ */
+typedef struct SDMMailboxSDC600Config {
+    uint64_t dataRegister;      //!< Offset of the data register, DR. Normally 0xD20.
+    uint64_t statusRegister;    //!< Offset of the status register, SR. Normally 0xD2C.
+    size_t pollRetries;         //!< Retry limit for status polls. Zero means use the engine timeout only.
+} SDMMailboxSDC600Config;
+
+/*!
+ * @brief SDC-600 flag bytes.
+ *
+ * Framing bytes used by the SDC-600 Secure Debug Channel. Message bytes with these values are escaped.
+ */
+enum SDMMailboxSDC600FlagEnum {
+    SDMMailboxSDC600_IDR = 0xA0,    //!< Identification request.
+    SDMMailboxSDC600_IDA = 0xA1,    //!< Identification acknowledge.
+    SDMMailboxSDC600_LPH1RA = 0xA6, //!< Link phase 1 request, activate.
+    SDMMailboxSDC600_LPH1RL = 0xA7, //!< Link phase 1 request, release.
+    SDMMailboxSDC600_LPH2RA = 0xA8, //!< Link phase 2 request, activate.
+    SDMMailboxSDC600_LPH2RL = 0xA9, //!< Link phase 2 request, release.
+    SDMMailboxSDC600_LPH2RR = 0xAA, //!< Link phase 2 request, reboot.
+    SDMMailboxSDC600_START = 0xAC,  //!< Start of message.
+    SDMMailboxSDC600_END = 0xAD,    //!< End of message.
+    SDMMailboxSDC600_ESC = 0xAE,    //!< Escape; the next byte has its top bit inverted.
+    SDMMailboxSDC600_NULL = 0xAF,   //!< Null byte, ignored by the receiver.
+};
+
+/*!
+ * @brief Parameters for SDMMailboxOpen().
+ */
+typedef struct SDMMailboxParameters {
+    //! The parameters passed to SDMOpen(). Provide the callbacks, refcon, version, flags, and host
+    //! capabilities. Must remain valid while the mailbox is open.
+    const SDMOpenParameters *openParams;
+    const SDMDeviceDescriptor *device;          //!< The mailbox device. Must remain valid while the mailbox is open.
+    const SDMMailboxTransport *transport;       //!< Transport. Must remain valid while the mailbox is open.
+    void *transportContext;                     //!< Value passed to the transport's functions.
+
+    //! Maximum number of batches queued at once when asynchronous callbacks are used. Zero selects a default.
+    size_t maxBatchesInFlight;
+
+    //! Maximum number of register operations in one batch. Zero selects a default.
+    size_t maxBatchOps;
+
+    //! Timeout for a message transfer, in microseconds. Zero means no timeout.
+    uint64_t timeoutUs;
+} SDMMailboxParameters;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Get the SDC-600 transport.
+ *
+ * The transport context must point to an #SDMMailboxSDC600Config. The status register bits and the
+ * framing follow the SDC-600 Secure Debug Channel specification.
+ *
+ * @return Pointer to the transport, valid for the lifetime of the process.
+ */
+const SDMMailboxTransport *SDMMailboxTransportSDC600(void);
+
+/*!
+ * @brief Create a mailbox engine.
+ *
+ * The engine allocates its batch buffers here, using #SDMCallbacks::acquireTransferBuffer when provided, so
+ * no allocation is done per message.
+ *
+ * @param[in] params Mailbox parameters.
+ * @param[out] mailbox Set to the mailbox handle on success.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_InternalError
+ */
+SDMReturnCode SDMMailboxOpen(const SDMMailboxParameters *params, SDMMailbox *mailbox);
+
+/*!
+ * @brief Establish the link with the target.
+ *
+ * Issues the operations from the transport's _connect_ function. Succeeds without I/O if the transport has
+ * no _connect_ function.
+ *
+ * @param[in] mailbox Mailbox handle.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_TimeoutError
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_RequestFailed The target did not accept the link.
+ */
+SDMReturnCode SDMMailboxConnect(SDMMailbox mailbox);
+
+/*!
+ * @brief Tear down the link with the target.
+ *
+ * @param[in] mailbox Mailbox handle.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_IOError
+ */
+SDMReturnCode SDMMailboxDisconnect(SDMMailbox mailbox);
+
+/*!
+ * @brief Send a whole message.
+ *
+ * Returns when the last batch of the message has completed.
+ *
+ * @param[in] mailbox Mailbox handle.
+ * @param[in] message Message to send.
+ * @param[in] messageSize Size in bytes of the message.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_TimeoutError
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_TransferFault
+ */
+SDMReturnCode SDMMailboxSend(SDMMailbox mailbox, const uint8_t *message, size_t messageSize);
+
+/*!
+ * @brief Receive a whole message.
+ *
+ * @param[in] mailbox Mailbox handle.
+ * @param[out] message Buffer that receives the message.
+ * @param[in] messageCapacity Size in bytes of the message buffer.
+ * @param[out] messageSize Set to the size in bytes of the received message.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument The message buffer is too small.
+ * @retval SDMReturnCode_TimeoutError
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_RequestFailed Framing error.
+ */
+SDMReturnCode SDMMailboxReceive(SDMMailbox mailbox, uint8_t *message, size_t messageCapacity, size_t *messageSize);
+
+/*!
+ * @brief Send a request message and receive the response.
+ *
+ * Equivalent to SDMMailboxSend() followed by SDMMailboxReceive(), except that the first receive batch is
+ * queued behind the last send batch instead of after it completes, saving one link round trip.
+ *
+ * @param[in] mailbox Mailbox handle.
+ * @param[in] request Request message.
+ * @param[in] requestSize Size in bytes of the request.
+ * @param[out] response Buffer that receives the response.
+ * @param[in] responseCapacity Size in bytes of the response buffer.
+ * @param[out] responseSize Set to the size in bytes of the response.
+ *
+ * @return The same values as SDMMailboxSend() and SDMMailboxReceive().
+ */
+SDMReturnCode SDMMailboxTransact(
+    SDMMailbox mailbox,
+    const uint8_t *request,
+    size_t requestSize,
+    uint8_t *response,
+    size_t responseCapacity,
+    size_t *responseSize);
+
+/*!
+ * @brief Destroy a mailbox engine.
+ *
+ * Cancels any batches still in flight with #SDMCallbacks::cancelAsyncRequest and waits for their completion.
+ *
+ * @param[in] mailbox Mailbox handle.
+ */
+void SDMMailboxClose(SDMMailbox mailbox);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* _SDM_DEBUG_MAILBOX_H_ */
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @addtogroup sdm_form_builder SDM Form Builder
+ * @brief Inline helpers for building an #SDMForm in a single memory block.
+ *
+ * The form builder lays out an #SDMForm, its element pointer array, its elements, and all strings, value
+ * buffers, and item arrays that the elements refer to, in one contiguous arena supplied by the caller. Building
+ * a form therefore needs one allocation, and releasing it needs one free. All strings passed to the builder are
+ * copied, so the finished form does not refer to any memory outside the arena.
+ *
+ * The builder supports a size query. If the arena is NULL, the builder only computes the required size, which
+ * SDMFormBuilderFinish() returns. The caller allocates a block of that size, and runs the same sequence of calls
+ * again with the block as the arena:
+ *
+ * @code
+ * SDMFormBuilder builder;
+ * size_t size;
+ * SDMFormBuilderInit(&builder, NULL, 0, "credential", "Select credential", NULL, 2);
+ * addElements(&builder);
+ * SDMFormBuilderFinish(&builder, NULL, &size);
+ *
+ * void *arena = malloc(size);
+ * const SDMForm *form;
+ * SDMFormBuilderInit(&builder, arena, size, "credential", "Select credential", NULL, 2);
+ * addElements(&builder);
+ * SDMFormBuilderFinish(&builder, &form, NULL);
+ * @endcode
+ *
+ * A finished form may be kept and presented again by later SDMAuthenticate() calls if its contents do not
+ * change. The element value buffers then hold the values from the previous presentation, which suits elements
+ * with #SDMForm_IsCacheable. The arena must be suitably aligned for pointers and 64-bit integers, as memory
+ * from `malloc()` is.
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines inline helpers for building SDM forms in a single memory block.
+ */
+
+#ifndef _SDM_FORM_BUILDER_H_
+#define _SDM_FORM_BUILDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "secure_debug_manager.h"
+
+//! @brief Alignment of every allocation within the arena.
+#define SDM_FORM_BUILDER_ALIGNMENT 8u
+
+/*!
+ * @brief Form builder state.
+ *
+ * Initialise with SDMFormBuilderInit(). Members are for use by the inline helpers only.
+ */
+typedef struct SDMFormBuilder {
+    uint8_t *arena;             //!< Arena, or NULL for a size query.
+    size_t capacity;            //!< Size in bytes of the arena.
+    size_t used;                //!< Bytes of the arena used, or required if greater than _capacity_.
+    SDMForm *form;              //!< The form, or NULL if it does not fit the arena.
+    const SDMFormElement **elementPointers; //!< Element pointer array, or NULL if it does not fit the arena.
+    SDMFormElement *elements;   //!< Element array, or NULL if it does not fit the arena.
+    uint32_t elementCapacity;   //!< Maximum number of elements.
+    uint32_t elementCount;      //!< Number of elements added.
+    SDMBool failed;             //!< Set if an argument was invalid or too many elements were added.
+} SDMFormBuilder;
+
+//! @brief Allocate zeroed, aligned arena space. Returns NULL if it does not fit, but always accounts for it.
+static inline void *_SDMFormBuilderAllocate(SDMFormBuilder *builder, size_t size)
+{
+    const size_t offset = (builder->used + (SDM_FORM_BUILDER_ALIGNMENT - 1)) & ~(size_t)(SDM_FORM_BUILDER_ALIGNMENT - 1);
+    builder->used = offset + size;
+    if (builder->arena == NULL || builder->used > builder->capacity) {
+        return NULL;
+    }
+    memset(builder->arena + offset, 0, size);
+    return builder->arena + offset;
+}
+
+//! @brief Copy a string into the arena. A NULL string stays NULL.
+static inline const char *_SDMFormBuilderString(SDMFormBuilder *builder, const char *text)
+{
+    if (text == NULL) {
+        return NULL;
+    }
+    const size_t length = strlen(text) + 1;
+    char *copy = (char *)_SDMFormBuilderAllocate(builder, length);
+    if (copy != NULL) {
+        memcpy(copy, text, length);
+    }
+    return copy;
+}
+
+//! @brief Copy a string into a new value buffer of the given length, truncating it if needed.
+static inline char *_SDMFormBuilderBuffer(SDMFormBuilder *builder, const char *initialValue, uint32_t bufferLength)
+{
+    char *buffer = (char *)_SDMFormBuilderAllocate(builder, bufferLength);
+    if (buffer != NULL && initialValue != NULL) {
+        size_t length = strlen(initialValue);
+        if (length > bufferLength - 1u) {
+            length = bufferLength - 1u;
+        }
+        memcpy(buffer, initialValue, length);
+    }
+    return buffer;
+}
+
+/*!
+ * @brief Add an element with the common fields set.
+ *
+ * Returns the element, or NULL if the arena is too small or this is a size query. The element pointer array is
+ * filled in by SDMFormBuilderFinish().
+ */
+static inline SDMFormElement *_SDMFormBuilderElement(
+    SDMFormBuilder *builder,
+    SDMFormElementType fieldType,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags)
+{
+    if (id == NULL || title == NULL || builder->elementCount == builder->elementCapacity) {
+        builder->failed = true;
+        return NULL;
+    }
+    const uint32_t index = builder->elementCount++;
+    const char *idCopy = _SDMFormBuilderString(builder, id);
+    const char *titleCopy = _SDMFormBuilderString(builder, title);
+    const char *helpCopy = _SDMFormBuilderString(builder, help);
+    if (builder->elements == NULL || idCopy == NULL || titleCopy == NULL || (help != NULL && helpCopy == NULL)) {
+        return NULL;
+    }
+    SDMFormElement *element = &builder->elements[index];
+    element->id = idCopy;
+    element->title = titleCopy;
+    element->help = helpCopy;
+    element->fieldType = fieldType;
+    element->flags = flags;
+    return element;
+}
+
+/*!
+ * @brief Start building a form.
+ *
+ * @param[out] builder Builder state.
+ * @param[in] arena Memory block in which to build the form, or NULL to only compute the required size.
+ * @param[in] arenaSize Size in bytes of the arena.
+ * @param[in] id Form ID. Must not be NULL.
+ * @param[in] title Form title. Must not be NULL.
+ * @param[in] info Additional description. May be NULL.
+ * @param[in] maxElements Maximum number of elements that will be added.
+ */
+static inline void SDMFormBuilderInit(
+    SDMFormBuilder *builder,
+    void *arena,
+    size_t arenaSize,
+    const char *id,
+    const char *title,
+    const char *info,
+    uint32_t maxElements)
+{
+    memset(builder, 0, sizeof(*builder));
+    builder->arena = (uint8_t *)arena;
+    builder->capacity = arena != NULL ? arenaSize : 0;
+    builder->elementCapacity = maxElements;
+    builder->failed = (id == NULL || title == NULL);
+
+    builder->form = (SDMForm *)_SDMFormBuilderAllocate(builder, sizeof(SDMForm));
+    builder->elementPointers = (const SDMFormElement **)_SDMFormBuilderAllocate(
+        builder, (size_t)maxElements * sizeof(SDMFormElement *));
+    builder->elements = (SDMFormElement *)_SDMFormBuilderAllocate(builder, (size_t)maxElements * sizeof(SDMFormElement));
+    const char *idCopy = _SDMFormBuilderString(builder, id);
+    const char *titleCopy = _SDMFormBuilderString(builder, title);
+    const char *infoCopy = _SDMFormBuilderString(builder, info);
+    if (builder->form != NULL) {
+        builder->form->id = idCopy;
+        builder->form->title = titleCopy;
+        builder->form->info = infoCopy;
+        builder->form->elements = builder->elementPointers;
+    }
+}
+
+//! @brief Add a static text element. Returns the element, or NULL if it was not built.
+static inline SDMFormElement *SDMFormBuilderAddStaticText(
+    SDMFormBuilder *builder,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags,
+    const char *text)
+{
+    if (text == NULL) {
+        builder->failed = true;
+        return NULL;
+    }
+    SDMFormElement *element = _SDMFormBuilderElement(builder, SDMForm_StaticText, id, title, help, flags);
+    const char *textCopy = _SDMFormBuilderString(builder, text);
+    if (element == NULL || textCopy == NULL) {
+        return NULL;
+    }
+    element->staticText.text = textCopy;
+    return element;
+}
+
+/*!
+ * @brief Add a text field element. Returns the element, or NULL if it was not built.
+ *
+ * The text buffer is allocated in the arena with _bufferLength_ bytes, and holds _initialValue_, which may be
+ * NULL for an empty field.
+ */
+static inline SDMFormElement *SDMFormBuilderAddTextField(
+    SDMFormBuilder *builder,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags,
+    const char *initialValue,
+    uint32_t bufferLength)
+{
+    if (bufferLength == 0) {
+        builder->failed = true;
+        return NULL;
+    }
+    SDMFormElement *element = _SDMFormBuilderElement(builder, SDMForm_TextField, id, title, help, flags);
+    char *buffer = _SDMFormBuilderBuffer(builder, initialValue, bufferLength);
+    if (element == NULL || buffer == NULL) {
+        return NULL;
+    }
+    element->textField.textBuffer = buffer;
+    element->textField.textBufferLength = bufferLength;
+    return element;
+}
+
+//! @brief Add a checkbox element with its state stored in the arena. Returns the element, or NULL if it was not built.
+static inline SDMFormElement *SDMFormBuilderAddCheckbox(
+    SDMFormBuilder *builder,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags,
+    SDMControlState initialState)
+{
+    SDMFormElement *element = _SDMFormBuilderElement(builder, SDMForm_Checkbox, id, title, help, flags);
+    SDMControlState *state = (SDMControlState *)_SDMFormBuilderAllocate(builder, sizeof(SDMControlState));
+    if (element == NULL || state == NULL) {
+        return NULL;
+    }
+    *state = initialState;
+    element->checkbox.state = state;
+    return element;
+}
+
+/*!
+ * @brief Add a path select element. Returns the element, or NULL if it was not built.
+ *
+ * The extensions array and its strings are copied. The path buffer is allocated in the arena with
+ * _bufferLength_ bytes, and holds _initialPath_, which may be NULL.
+ */
+static inline SDMFormElement *SDMFormBuilderAddPathSelect(
+    SDMFormBuilder *builder,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags,
+    const char **extensions,
+    uint32_t extensionsCount,
+    const char *initialPath,
+    uint32_t bufferLength)
+{
+    if (bufferLength == 0 || (extensions == NULL && extensionsCount != 0)) {
+        builder->failed = true;
+        return NULL;
+    }
+    SDMFormElement *element = _SDMFormBuilderElement(builder, SDMForm_PathSelect, id, title, help, flags);
+    const char **extensionsCopy = NULL;
+    SDMBool complete = true;
+    if (extensions != NULL) {
+        extensionsCopy = (const char **)_SDMFormBuilderAllocate(builder, (size_t)extensionsCount * sizeof(char *));
+        for (uint32_t i = 0; i < extensionsCount; ++i) {
+            const char *extension = _SDMFormBuilderString(builder, extensions[i]);
+            if (extensionsCopy != NULL) {
+                extensionsCopy[i] = extension;
+            }
+            complete = complete && (extension != NULL || extensions[i] == NULL);
+        }
+        complete = complete && extensionsCopy != NULL;
+    }
+    char *buffer = _SDMFormBuilderBuffer(builder, initialPath, bufferLength);
+    if (element == NULL || buffer == NULL || !complete) {
+        return NULL;
+    }
+    element->pathSelect.extensions = extensionsCopy;
+    element->pathSelect.extensionsCount = extensionsCount;
+    element->pathSelect.pathBuffer = buffer;
+    element->pathSelect.pathBufferLength = bufferLength;
+    return element;
+}
+
+/*!
+ * @brief Add an item select element. Returns the element, or NULL if it was not built.
+ *
+ * The items array and its strings are copied. The selection index is stored in the arena.
+ */
+static inline SDMFormElement *SDMFormBuilderAddItemSelect(
+    SDMFormBuilder *builder,
+    const char *id,
+    const char *title,
+    const char *help,
+    uint32_t flags,
+    const SDMFormItemInfo *items,
+    uint32_t itemCount,
+    int32_t initialSelection)
+{
+    if (items == NULL) {
+        builder->failed = true;
+        return NULL;
+    }
+    SDMFormElement *element = _SDMFormBuilderElement(builder, SDMForm_ItemSelect, id, title, help, flags);
+    SDMFormItemInfo *itemsCopy = (SDMFormItemInfo *)_SDMFormBuilderAllocate(
+        builder, (size_t)itemCount * sizeof(SDMFormItemInfo));
+    SDMBool complete = itemsCopy != NULL || itemCount == 0;
+    for (uint32_t i = 0; i < itemCount; ++i) {
+        const char *name = _SDMFormBuilderString(builder, items[i].itemShortName);
+        const char *description = _SDMFormBuilderString(builder, items[i].itemLongDescription);
+        if (itemsCopy != NULL) {
+            itemsCopy[i].itemShortName = name;
+            itemsCopy[i].itemLongDescription = description;
+        }
+        complete = complete && name != NULL && (description != NULL || items[i].itemLongDescription == NULL);
+    }
+    int32_t *selection = (int32_t *)_SDMFormBuilderAllocate(builder, sizeof(int32_t));
+    if (element == NULL || selection == NULL || !complete) {
+        return NULL;
+    }
+    *selection = initialSelection;
+    element->itemSelect.items = itemsCopy;
+    element->itemSelect.itemCount = itemCount;
+    element->itemSelect.selectionIndex = selection;
+    return element;
+}
+
+/*!
+ * @brief Finish building a form.
+ *
+ * @param[in,out] builder Builder state.
+ * @param[out] form Set to the finished form, or to NULL if it was not built. May be NULL for a size query.
+ * @param[out] requiredSize Set to the arena size in bytes required for the form. May be NULL.
+ *
+ * @retval SDMReturnCode_Success The form was built, or this was a size query.
+ * @retval SDMReturnCode_InvalidArgument The arena is too small, an argument to one of the builder functions
+ *  was invalid, or more than _maxElements_ elements were added.
+ */
+static inline SDMReturnCode SDMFormBuilderFinish(SDMFormBuilder *builder, const SDMForm **form, size_t *requiredSize)
+{
+    if (requiredSize != NULL) {
+        *requiredSize = builder->used;
+    }
+    if (form != NULL) {
+        *form = NULL;
+    }
+    if (builder->failed) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    if (builder->arena == NULL) {
+        return SDMReturnCode_Success;
+    }
+    if (builder->used > builder->capacity) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    for (uint32_t i = 0; i < builder->elementCount; ++i) {
+        builder->elementPointers[i] = &builder->elements[i];
+    }
+    builder->form->elementCount = builder->elementCount;
+    if (form != NULL) {
+        *form = builder->form;
+    }
+    return SDMReturnCode_Success;
+}
+
+/** @} */
+
+#endif /* _SDM_FORM_BUILDER_H_ */
@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @addtogroup sdm_manifest_cache SDM Manifest Cache
+ * @brief Pre-parsed binary form of the SDM manifest.
+ *
+ * The manifest cache is a compact binary encoding of an SDM manifest XML file that has been validated
+ * against `manifest.xsd`. It lets a host find the `<libraries>` entry for its OS and architecture, and
+ * query `<capabilities>` features and `<performance>` hints, without starting an XML parser. The format is
+ * designed to be memory mapped and used in place.
+ *
+ * Creating and storing cache files is the responsibility of the host. A cache file is typically kept in a
+ * host-specific cache directory, keyed by the absolute path of the manifest. An SDM vendor may also ship a
+ * cache file next to the manifest, with the manifest's file name plus a `.sdmcache` suffix; because file
+ * modification times usually change on installation, such a file is only trusted after a digest check.
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines the SDM manifest cache format and inline helpers for reading it.
+ */
+
+#ifndef _SDM_MANIFEST_CACHE_H_
+#define _SDM_MANIFEST_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Format rules:
+// - All integers are little-endian.
+// - All offsets are in bytes from the start of the cache, and every record array is aligned to 8 bytes.
+// - Strings are null-terminated UTF-8 and are referenced by their offset within the string table.
+// - Record arrays are sorted so they can be searched with a binary search. Sort order is by bytewise
+//   comparison of the referenced strings, like strcmp().
+
+/*!
+ * @brief Constants for the manifest cache format.
+ */
+enum SDMManifestCacheConstantsEnum {
+    SDMManifestCache_Magic = 0x4D4D4453,        //!< Value of SDMManifestCacheHeader::magic; "SDMM" in file order.
+    SDMManifestCache_FormatVersion = 1,         //!< Current value of SDMManifestCacheHeader::formatVersion.
+    SDMManifestCache_DigestSize = 32,           //!< Size in bytes of the SHA-256 manifest digest.
+};
+
+//! @brief Offset of a string within the cache's string table.
+typedef uint32_t SDMManifestStringRef;
+
+//! @brief Value of an #SDMManifestStringRef for an absent optional attribute.
+#define SDM_MANIFEST_NO_STRING ((SDMManifestStringRef)0xFFFFFFFFu)
+
+/*!
+ * @brief Flags for manifest cache feature records.
+ */
+enum SDMManifestFeatureFlagsEnum {
+    SDMManifestFeature_Enabled = (1 << 0),  //!< The feature's `enable` attribute is "true" or absent.
+};
+
+/*!
+ * @brief Flags for manifest cache library records.
+ */
+enum SDMManifestLibraryFlagsEnum {
+    SDMManifestLibrary_Lazy = (1 << 0),     //!< The library's `load` attribute is "lazy".
+};
+
+/*!
+ * @brief Manifest cache file header.
+ *
+ * The header is at offset 0 of the cache.
+ *
+ * A cache is valid for a manifest XML file only if all of these conditions hold:
+ * - _magic_ and _formatVersion_ have the expected values, and _fileSize_ equals the size of the cache.
+ * - _sourceSize_ equals the current size of the manifest XML file.
+ * - Either _sourceMtimeNs_ equals the manifest's current modification time, or the SHA-256 digest of the
+ *   manifest's current contents equals _sourceDigest_.
+ *
+ * If a cache is found to be invalid, the host must parse and validate the manifest XML, and should then
+ * rewrite the cache. If only the modification time differs but the digest matches, the host may update
+ * _sourceMtimeNs_ in place.
+ */
+typedef struct SDMManifestCacheHeader {
+    uint32_t magic;             //!< Must be #SDMManifestCache_Magic.
+    uint32_t formatVersion;     //!< Cache format version. Must be #SDMManifestCache_FormatVersion.
+    uint32_t fileSize;          //!< Total size in bytes of the cache.
+    uint32_t flags;             //!< Reserved for future use. Must be zero.
+
+    uint64_t sourceSize;        //!< Size in bytes of the manifest XML file the cache was generated from.
+    int64_t sourceMtimeNs;      //!< Modification time of the manifest XML file, in nanoseconds since the Unix epoch.
+    uint8_t sourceDigest[SDMManifestCache_DigestSize]; //!< SHA-256 digest of the manifest XML file contents.
+
+    struct {
+        uint16_t major;         //!< Major version.
+        uint16_t minor;         //!< Minor version.
+    } manifestVersion;          //!< Value of the `<manifest>` element's `version` attribute.
+    struct {
+        uint16_t major;         //!< Major version.
+        uint16_t minor;         //!< Minor version.
+    } apiVersion;               //!< Value of the `<api>` element's `version` attribute.
+
+    uint32_t stringTableOffset; //!< Offset of the string table.
+    uint32_t stringTableSize;   //!< Size in bytes of the string table.
+    uint32_t librarySetOffset;  //!< Offset of the #SDMManifestLibrarySet array.
+    uint32_t librarySetCount;   //!< Number of #SDMManifestLibrarySet records.
+    uint32_t libraryOffset;     //!< Offset of the #SDMManifestLibrary array.
+    uint32_t libraryCount;      //!< Number of #SDMManifestLibrary records.
+    uint32_t featureOffset;     //!< Offset of the #SDMManifestFeature array.
+    uint32_t featureCount;      //!< Number of #SDMManifestFeature records.
+    uint32_t resourceOffset;    //!< Offset of the #SDMManifestResource array.
+    uint32_t resourceCount;     //!< Number of #SDMManifestResource records.
+    SDMManifestStringRef config; //!< Verbatim XML content of the `<config>` element, or #SDM_MANIFEST_NO_STRING.
+    uint32_t performanceOffset; //!< Offset of the #SDMManifestPerformance record, or 0 if there is no `<performance>` element.
+    uint32_t reserved[2];       //!< Reserved for future use. Must be zero.
+} SDMManifestCacheHeader;
+
+/*!
+ * @brief One `<libraries>` element.
+ *
+ * Records are sorted by _os_, then by _arch_.
+ */
+typedef struct SDMManifestLibrarySet {
+    SDMManifestStringRef os;    //!< Value of the `os` attribute.
+    SDMManifestStringRef arch;  //!< Value of the `arch` attribute.
+    uint32_t firstLibrary;      //!< Index of the set's first #SDMManifestLibrary record.
+    uint32_t libraryCount;      //!< Number of libraries in the set, in manifest order.
+} SDMManifestLibrarySet;
+
+/*!
+ * @brief One `<lib>` element.
+ */
+typedef struct SDMManifestLibrary {
+    SDMManifestStringRef path;  //!< Value of the `path` attribute, relative to the manifest.
+    uint32_t flags;             //!< Mask composed of #SDMManifestLibraryFlagsEnum enums.
+} SDMManifestLibrary;
+
+/*!
+ * @brief One `<capabilities>` `<feature>` element.
+ *
+ * Records are sorted by _name_.
+ */
+typedef struct SDMManifestFeature {
+    SDMManifestStringRef name;  //!< Value of the `name` attribute.
+    SDMManifestStringRef value; //!< Value of the `value` attribute, or #SDM_MANIFEST_NO_STRING.
+    uint32_t flags;             //!< Mask composed of #SDMManifestFeatureFlagsEnum enums.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMManifestFeature;
+
+/*!
+ * @brief One `<resources>` `<resource>` element.
+ *
+ * Records are in manifest order.
+ */
+typedef struct SDMManifestResource {
+    SDMManifestStringRef type;  //!< Value of the `type` attribute, or #SDM_MANIFEST_NO_STRING.
+    SDMManifestStringRef path;  //!< Value of the `path` attribute, relative to the manifest.
+    SDMManifestStringRef info;  //!< Value of the `info` attribute, or #SDM_MANIFEST_NO_STRING.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMManifestResource;
+
+/*!
+ * @brief The `<performance>` element.
+ *
+ * Each field holds the `value` attribute of the element of the same name, or 0 if the element is absent.
+ */
+typedef struct SDMManifestPerformance {
+    uint32_t transferChunkSize;             //!< `transfer-chunk-size`, in bytes.
+    uint32_t pollIntervalUs;                //!< `poll-interval`, in microseconds.
+    uint32_t maxParallelSessions;           //!< `max-parallel-sessions`.
+    uint32_t typicalAuthenticationMs;       //!< `typical-authentication-duration`, in milliseconds.
+    uint32_t maxAuthenticationMs;           //!< `max-authentication-duration`, in milliseconds.
+    uint32_t reserved[3];                   //!< Reserved for future use. Must be zero.
+} SDMManifestPerformance;
+
+//! @name Inline helpers
+//!
+//! These helpers operate on a cache that is loaded or mapped into memory at an 8-byte aligned address. They
+//! assume a little-endian host.
+//@{
+
+/*!
+ * @brief Check the structure of a manifest cache.
+ *
+ * Verifies the header constants and that all record arrays and the string table lie within the cache. The
+ * source manifest checks described for #SDMManifestCacheHeader must be performed separately.
+ *
+ * @param[in] data Pointer to the cache contents.
+ * @param[in] size Size in bytes of the cache contents.
+ * @return The cache header, or NULL if the cache is malformed.
+ */
+static inline const SDMManifestCacheHeader *SDMManifestCacheCheck(const void *data, size_t size)
+{
+    const SDMManifestCacheHeader *header = (const SDMManifestCacheHeader *)data;
+    if (data == NULL || size < sizeof(SDMManifestCacheHeader)
+            || header->magic != SDMManifestCache_Magic
+            || header->formatVersion != SDMManifestCache_FormatVersion
+            || header->fileSize != size) {
+        return NULL;
+    }
+    // The helpers cast record array offsets to struct pointers, so misaligned offsets must be rejected.
+    if (header->librarySetOffset % 8 != 0 || header->libraryOffset % 8 != 0 || header->featureOffset % 8 != 0
+            || header->resourceOffset % 8 != 0 || header->performanceOffset % 8 != 0) {
+        return NULL;
+    }
+    const uint64_t limit = size;
+    if ((uint64_t)header->stringTableOffset + header->stringTableSize > limit
+            || header->stringTableSize == 0
+            || ((const char *)data)[header->stringTableOffset + header->stringTableSize - 1] != '\0'
+            || (uint64_t)header->librarySetOffset + (uint64_t)header->librarySetCount * sizeof(SDMManifestLibrarySet) > limit
+            || (uint64_t)header->libraryOffset + (uint64_t)header->libraryCount * sizeof(SDMManifestLibrary) > limit
+            || (uint64_t)header->featureOffset + (uint64_t)header->featureCount * sizeof(SDMManifestFeature) > limit
+            || (uint64_t)header->resourceOffset + (uint64_t)header->resourceCount * sizeof(SDMManifestResource) > limit
+            || (uint64_t)header->performanceOffset + sizeof(SDMManifestPerformance) > limit) {
+        return NULL;
+    }
+    return header;
+}
+
+/*!
+ * @brief Get a string from the cache's string table.
+ *
+ * @param[in] header Cache header returned by SDMManifestCacheCheck().
+ * @param[in] ref String reference.
+ * @return Pointer to the null-terminated string, or NULL if _ref_ is #SDM_MANIFEST_NO_STRING or out of range.
+ */
+static inline const char *SDMManifestCacheString(const SDMManifestCacheHeader *header, SDMManifestStringRef ref)
+{
+    if (ref == SDM_MANIFEST_NO_STRING || ref >= header->stringTableSize) {
+        return NULL;
+    }
+    return (const char *)header + header->stringTableOffset + ref;
+}
+
+/*!
+ * @brief Find the `<libraries>` entry for an OS and architecture.
+ *
+ * @param[in] header Cache header returned by SDMManifestCacheCheck().
+ * @param[in] os OS name to match.
+ * @param[in] arch Architecture name to match.
+ * @return Pointer to the matching library set record, or NULL if there is no match.
+ */
+static inline const SDMManifestLibrarySet *SDMManifestCacheFindLibrarySet(
+    const SDMManifestCacheHeader *header,
+    const char *os,
+    const char *arch)
+{
+    const SDMManifestLibrarySet *sets =
+        (const SDMManifestLibrarySet *)((const char *)header + header->librarySetOffset);
+    size_t low = 0;
+    size_t high = header->librarySetCount;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const char *midOs = SDMManifestCacheString(header, sets[mid].os);
+        const char *midArch = SDMManifestCacheString(header, sets[mid].arch);
+        if (midOs == NULL || midArch == NULL) {
+            return NULL;
+        }
+        int order = strcmp(midOs, os);
+        if (order == 0) {
+            order = strcmp(midArch, arch);
+        }
+        if (order == 0) {
+            return &sets[mid];
+        }
+        else if (order < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Get a library record.
+ *
+ * @param[in] header Cache header returned by SDMManifestCacheCheck().
+ * @param[in] set Library set returned by SDMManifestCacheFindLibrarySet().
+ * @param[in] index Index of the library within the set.
+ * @return Pointer to the library record, or NULL if _index_ is out of range.
+ */
+static inline const SDMManifestLibrary *SDMManifestCacheLibrary(
+    const SDMManifestCacheHeader *header,
+    const SDMManifestLibrarySet *set,
+    uint32_t index)
+{
+    if (index >= set->libraryCount || (uint64_t)set->firstLibrary + index >= header->libraryCount) {
+        return NULL;
+    }
+    const SDMManifestLibrary *libraries =
+        (const SDMManifestLibrary *)((const char *)header + header->libraryOffset);
+    return &libraries[set->firstLibrary + index];
+}
+
+/*!
+ * @brief Find a `<capabilities>` feature by name.
+ *
+ * Note that a feature that is not listed in the manifest is disabled, so a NULL result has the same meaning as
+ * a record without #SDMManifestFeature_Enabled.
+ *
+ * @param[in] header Cache header returned by SDMManifestCacheCheck().
+ * @param[in] name Feature name to match.
+ * @return Pointer to the matching feature record, or NULL if there is no match.
+ */
+static inline const SDMManifestFeature *SDMManifestCacheFindFeature(
+    const SDMManifestCacheHeader *header,
+    const char *name)
+{
+    const SDMManifestFeature *features =
+        (const SDMManifestFeature *)((const char *)header + header->featureOffset);
+    size_t low = 0;
+    size_t high = header->featureCount;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const char *midName = SDMManifestCacheString(header, features[mid].name);
+        if (midName == NULL) {
+            return NULL;
+        }
+        const int order = strcmp(midName, name);
+        if (order == 0) {
+            return &features[mid];
+        }
+        else if (order < 0) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Get the `<performance>` hints.
+ *
+ * @param[in] header Cache header returned by SDMManifestCacheCheck().
+ * @return Pointer to the performance record, or NULL if the manifest has no `<performance>` element.
+ */
+static inline const SDMManifestPerformance *SDMManifestCachePerformance(const SDMManifestCacheHeader *header)
+{
+    if (header->performanceOffset == 0) {
+        return NULL;
+    }
+    return (const SDMManifestPerformance *)((const char *)header + header->performanceOffset);
+}
+//@}
+
+/** @} */
+
+#endif /* _SDM_MANIFEST_CACHE_H_ */
@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @addtogroup sdm_trace SDM Callback Trace
+ * @brief Binary trace format for recording SDM callback traffic.
+ *
+ * An SDM callback trace is a compact record of the #SDMCallbacks calls made by an SDM, with their timing,
+ * arguments, and results. A host writes a trace by wrapping its callback table in a recording shim, for example
+ * when an authentication is unexpectedly slow in the field. A replay driver can then feed the recorded results
+ * back to the same or a different SDM build, without the target, to reproduce and bisect latency regressions
+ * offline.
+ *
+ * A trace is a file header followed by a sequence of records. Each record has a common header, which holds the
+ * record type, the result, and the start time and duration of the call, followed by a type-specific payload.
+ * Payloads are defined for the callbacks that generate link traffic, including the asynchronous and write stream
+ * callbacks, and for the transaction group callbacks. Records of other callbacks have an empty payload in this
+ * format version.
+ *
+ * Records are written in this order:
+ * - A callback record is written when the callback returns.
+ * - The records of calls within a transaction group are written when #SDMCallbacks::commitTransactionGroup
+ *   returns, in call order and before the record of the commit, so that their read data is valid.
+ * - An asynchronous callback record describes the queuing of the request. Its completion is described by an
+ *   #SDMTraceRecord_AsyncCompletion record, written when the host invokes the completion routine. The two
+ *   records share a request identifier. The completion record precedes the request record if the host
+ *   completes the request before the asynchronous callback returns.
+ * - An #SDMTraceRecord_ApiCall record is written when the SDM API call it describes returns, following the
+ *   records of the callbacks made during the call.
+ *
+ * Traces contain the data read from and written to the target, which may include secrets such as signed
+ * debug certificates. Hosts should treat trace files with the same care as the credentials themselves.
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines the SDM callback trace format and inline helpers for reading it.
+ */
+
+#ifndef _SDM_TRACE_H_
+#define _SDM_TRACE_H_
+
+#include "secure_debug_manager.h"
+
+#include <string.h>
+
+// Format rules:
+// - All integers are little-endian.
+// - Every record starts at an offset that is a multiple of 8 bytes, and its size is a multiple of 8 bytes.
+//   Payloads are padded with zero bytes to the record size.
+// - Timestamps are in nanoseconds from SDMTraceFileHeader::startTimeNs, on a monotonic clock.
+// - Data arrays hold transfer elements of the recorded transfer size, in little-endian byte order.
+
+/*!
+ * @brief Constants for the trace format.
+ */
+enum SDMTraceConstantsEnum {
+    SDMTrace_Magic = 0x544D4453,                //!< Value of SDMTraceFileHeader::magic; "SDMT" in file order.
+    SDMTrace_FormatVersion = 1,                 //!< Current value of SDMTraceFileHeader::formatVersion.
+    SDMTrace_Alignment = 8,                     //!< Alignment of records and record sizes.
+};
+
+//! @brief Round a size up to the record alignment.
+#define SDM_TRACE_ALIGN(size) (((size) + (SDMTrace_Alignment - 1)) & ~(size_t)(SDMTrace_Alignment - 1))
+
+/*!
+ * @brief Trace record types.
+ *
+ * Types less than #SDMTraceRecord_ApiCall are callback records; the type is the #SDMCallbackIdEnum value of
+ * the callback.
+ */
+enum SDMTraceRecordTypeEnum {
+    SDMTraceRecord_ApiCall = 0x100,     //!< An SDM API call made by the host. The payload is #SDMTraceApiCall.
+
+    //! The completion of an asynchronous request. The payload is #SDMTraceAsyncCompletion.
+    SDMTraceRecord_AsyncCompletion = 0x101,
+};
+
+/*!
+ * @brief Flags for trace records.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMTraceRecordHeader::flags field.
+ */
+enum SDMTraceRecordFlagsEnum {
+    SDMTraceRecordFlag_Grouped = (1 << 0),  //!< The call was made within a transaction group.
+};
+
+/*!
+ * @brief SDM API calls in #SDMTraceRecord_ApiCall records.
+ */
+enum SDMTraceApiEnum {
+    SDMTraceApi_Open = 1,               //!< SDMOpen().
+    SDMTraceApi_Authenticate = 2,       //!< SDMAuthenticate().
+    SDMTraceApi_ResumeBoot = 3,         //!< SDMResumeBoot().
+    SDMTraceApi_Reattach = 4,           //!< SDMReattach().
+    SDMTraceApi_Close = 5,              //!< SDMClose().
+};
+
+/*!
+ * @brief Flags for trace device descriptors.
+ */
+enum SDMTraceDeviceFlagsEnum {
+    SDMTraceDevice_HasMemAp = (1 << 0), //!< SDMTraceDevice::memApAddress is valid.
+};
+
+/*!
+ * @brief Trace file header.
+ *
+ * The header is at offset 0 of the trace, and is followed by the first record at offset _headerSize_.
+ */
+typedef struct SDMTraceFileHeader {
+    uint32_t magic;             //!< Must be #SDMTrace_Magic.
+    uint32_t formatVersion;     //!< Trace format version. Must be #SDMTrace_FormatVersion.
+    uint32_t headerSize;        //!< Size in bytes of the file header. A multiple of 8.
+    uint32_t flags;             //!< Reserved for future use. Must be zero.
+    uint16_t apiMajor;          //!< Major version of the SDM API used by the host.
+    uint16_t apiMinor;          //!< Minor version of the SDM API used by the host.
+    uint32_t hostCapabilities;  //!< SDMHostCapabilities::flags of the recording host, or 0 if none were passed.
+    int64_t startTimeNs;        //!< Wall-clock time at the start of the trace, in nanoseconds since the Unix epoch.
+} SDMTraceFileHeader;
+
+/*!
+ * @brief Common header of every trace record.
+ */
+typedef struct SDMTraceRecordHeader {
+    uint32_t size;              //!< Size in bytes of the record, including this header. A multiple of 8.
+    uint16_t type;              //!< Record type, a callback ID or an #SDMTraceRecordTypeEnum value.
+    uint16_t flags;             //!< Mask composed of #SDMTraceRecordFlagsEnum enums.
+    uint32_t result;            //!< Returned #SDMReturnCode, or 0 for callbacks that return void.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t timestampNs;       //!< Time at which the call was made.
+    uint64_t durationNs;        //!< Time the call took to return.
+} SDMTraceRecordHeader;
+
+/*!
+ * @brief Encoded #SDMDeviceDescriptor.
+ *
+ * For an #SDMDeviceType_ArmADI_AP device, _address_ is the AP address. For an
+ * #SDMDeviceType_ArmADI_CoreSightComponent device, _address_ is the component base address and, if the
+ * component is accessed through a MEM-AP, _memApAddress_ is the address of that MEM-AP.
+ */
+typedef struct SDMTraceDevice {
+    uint32_t deviceType;        //!< The #SDMDeviceType of the device.
+    uint8_t dpIndex;            //!< Debug Port index.
+    uint8_t flags;              //!< Mask composed of #SDMTraceDeviceFlagsEnum enums.
+    uint16_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t address;           //!< AP address or component base address.
+    uint64_t memApAddress;      //!< Address of the MEM-AP of a CoreSight component.
+} SDMTraceDevice;
+
+/*!
+ * @brief Payload of #SDMCallbackId_ResetStart and #SDMCallbackId_ResetFinish records.
+ */
+typedef struct SDMTraceReset {
+    uint32_t resetType;         //!< The #SDMResetType argument.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMTraceReset;
+
+/*!
+ * @brief Payload of #SDMCallbackId_ReadMemory and #SDMCallbackId_WriteMemory records.
+ *
+ * Followed by _transferCount_ elements of _transferSize_, which are the data written, or the contents of the
+ * SDM's buffer after a read.
+ */
+typedef struct SDMTraceMemory {
+    SDMTraceDevice device;      //!< Device through which the transfer was performed.
+    uint64_t address;           //!< Memory address.
+    uint32_t transferSize;      //!< The #SDMTransferSize argument.
+    uint32_t attributes;        //!< Transfer attributes.
+    uint64_t transferCount;     //!< Number of elements transferred.
+} SDMTraceMemory;
+
+/*!
+ * @brief One register access operation within an #SDMTraceRegisterAccess payload.
+ *
+ * Fields have the meaning of the #SDMRegisterAccessEx fields with the same names. For #SDMCallbackId_RegisterAccess
+ * records, the fields that #SDMRegisterAccess does not have are zero, and _count_ is 1.
+ */
+typedef struct SDMTraceRegisterOp {
+    uint64_t address;           //!< Register address.
+    uint32_t op;                //!< The #SDMRegisterAccessOp.
+    uint32_t flags;             //!< Mask composed of #SDMRegisterAccessFlagsEnum enums.
+    uint64_t pollMask;          //!< Poll mask.
+    uint64_t pollTimeoutUs;     //!< Poll timeout in microseconds.
+    uint32_t pollIntervalUs;    //!< Minimum poll interval in microseconds.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t retries;           //!< Poll retry count.
+    uint64_t count;             //!< Number of elements, 1 for operations other than block operations.
+    uint64_t gateAddress;       //!< Gate status register address.
+    uint64_t gateValue;         //!< Gate status register match value.
+} SDMTraceRegisterOp;
+
+/*!
+ * @brief Payload of #SDMCallbackId_RegisterAccess and #SDMCallbackId_RegisterAccessEx records.
+ *
+ * Followed by _accessCount_ #SDMTraceRegisterOp records, then, for each operation in order, _count_ elements of
+ * _transferSize_ holding the operation's values after the call: the values read, the values written, or the
+ * poll match value.
+ */
+typedef struct SDMTraceRegisterAccess {
+    SDMTraceDevice device;      //!< Device through which the accesses were performed.
+    uint32_t transferSize;      //!< The #SDMTransferSize argument.
+    uint32_t accessCount;       //!< Number of operations.
+    uint64_t accessesCompleted; //!< Value returned through _accessesCompleted_.
+} SDMTraceRegisterAccess;
+
+/*!
+ * @brief One transfer within an #SDMTraceMemoryBatch payload.
+ */
+typedef struct SDMTraceMemoryBatchAccess {
+    SDMTraceDevice device;      //!< Device through which the transfer was performed.
+    uint64_t address;           //!< Memory address.
+    uint32_t transferSize;      //!< The #SDMTransferSize of the transfer.
+    uint32_t direction;         //!< The #SDMTransferDirection of the transfer.
+    uint64_t transferCount;     //!< Number of elements transferred.
+    uint32_t attributes;        //!< Transfer attributes.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMTraceMemoryBatchAccess;
+
+/*!
+ * @brief Payload of #SDMCallbackId_TransferMemoryBatch records.
+ *
+ * Followed by _accessCount_ #SDMTraceMemoryBatchAccess records, then the data of each transfer in order, as for
+ * #SDMTraceMemory.
+ */
+typedef struct SDMTraceMemoryBatch {
+    uint32_t accessCount;       //!< Number of transfers.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t accessesCompleted; //!< Value returned through _accessesCompleted_.
+} SDMTraceMemoryBatch;
+
+/*!
+ * @brief Payload of #SDMCallbackId_BeginTransactionGroup and #SDMCallbackId_CommitTransactionGroup records.
+ */
+typedef struct SDMTraceTransactionGroup {
+    uint32_t flags;             //!< For a begin, the _flags_ argument; otherwise zero.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t callsCompleted;    //!< For a commit, the value returned through _callsCompleted_; otherwise zero.
+} SDMTraceTransactionGroup;
+
+/*!
+ * @brief Start of the payload of asynchronous request records.
+ *
+ * The payload of an #SDMCallbackId_ReadMemoryAsync or #SDMCallbackId_WriteMemoryAsync record is this structure
+ * followed by an #SDMTraceMemory payload. For a write, the #SDMTraceMemory payload is followed by the data
+ * written; the data of a read is in the completion record.
+ *
+ * The payload of an #SDMCallbackId_RegisterAccessAsync record is this structure followed by an
+ * #SDMTraceRegisterAccess payload with a zero _accessesCompleted_. The values of read operations are zero; they
+ * are in the completion record.
+ */
+typedef struct SDMTraceAsyncRequest {
+    uint64_t requestId;         //!< Identifier of the request, unique within the trace.
+    uint64_t token;             //!< Token assigned by the host, or zero if the request was not queued.
+} SDMTraceAsyncRequest;
+
+/*!
+ * @brief Payload of #SDMTraceRecord_AsyncCompletion records.
+ *
+ * The record header's _result_ is the result passed to the completion routine, its _timestampNs_ is the time
+ * at which the request was queued, and its _durationNs_ is the time from then until the completion routine was
+ * invoked.
+ *
+ * For a read memory request, the payload is followed by the _transferCount_ elements of the request's buffer.
+ * For a register access request, it is followed by one element for each read operation of the request, in order.
+ */
+typedef struct SDMTraceAsyncCompletion {
+    uint64_t requestId;         //!< Identifier of the request, as in its #SDMTraceAsyncRequest.
+    uint64_t token;             //!< Token passed to the completion routine.
+    uint64_t completedCount;    //!< Count passed to the completion routine.
+    uint32_t callback;          //!< The #SDMCallbackId of the request.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMTraceAsyncCompletion;
+
+/*!
+ * @brief Payload of #SDMCallbackId_CancelAsyncRequest records.
+ */
+typedef struct SDMTraceAsyncCancel {
+    uint64_t token;             //!< The _token_ argument.
+} SDMTraceAsyncCancel;
+
+/*!
+ * @brief Payload of #SDMCallbackId_OpenWriteStream records.
+ */
+typedef struct SDMTraceWriteStream {
+    SDMTraceDevice device;      //!< Device through which the writes are performed.
+    uint64_t address;           //!< Target address of the first byte of the payload.
+    uint32_t transferSize;      //!< The #SDMTransferSize argument.
+    uint32_t attributes;        //!< Transfer attributes.
+    uint64_t totalSize;         //!< The _totalSize_ argument.
+    uint64_t stream;            //!< Value of the stream handle, identifying the stream, or zero if none was opened.
+} SDMTraceWriteStream;
+
+/*!
+ * @brief Payload of #SDMCallbackId_WriteStreamChunk records.
+ *
+ * Followed by the _size_ bytes of the chunk.
+ */
+typedef struct SDMTraceWriteStreamChunk {
+    uint64_t stream;            //!< Value of the stream handle.
+    uint64_t size;              //!< Size in bytes of the chunk.
+    uint32_t flags;             //!< Mask composed of #SDMWriteChunkFlagsEnum enums.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMTraceWriteStreamChunk;
+
+/*!
+ * @brief Payload of #SDMCallbackId_CloseWriteStream records.
+ */
+typedef struct SDMTraceWriteStreamClose {
+    uint64_t stream;            //!< Value of the stream handle.
+    uint32_t abort;             //!< The _abort_ argument.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+    uint64_t bytesWritten;      //!< Value returned through _bytesWritten_.
+} SDMTraceWriteStreamClose;
+
+/*!
+ * @brief Payload of #SDMTraceRecord_ApiCall records.
+ */
+typedef struct SDMTraceApiCall {
+    uint32_t api;               //!< The call, one of the #SDMTraceApiEnum enumerators.
+    uint32_t reserved;          //!< Reserved for future use. Must be zero.
+} SDMTraceApiCall;
+
+//! @name Inline helpers
+//!
+//! These helpers operate on a trace that is loaded or mapped into memory at an 8-byte aligned address. They
+//! assume a little-endian host.
+//@{
+
+/*!
+ * @brief Encode a device descriptor for a trace record.
+ *
+ * @param[in] device Device descriptor, or NULL.
+ * @param[out] encoded Set to the encoded descriptor; all zero if _device_ is NULL.
+ */
+static inline void SDMTraceEncodeDevice(const SDMDeviceDescriptor *device, SDMTraceDevice *encoded)
+{
+    memset(encoded, 0, sizeof(*encoded));
+    if (device == NULL) {
+        return;
+    }
+    encoded->deviceType = device->deviceType;
+    if (device->deviceType == SDMDeviceType_ArmADI_AP) {
+        encoded->dpIndex = device->armAP.dpIndex;
+        encoded->address = device->armAP.address;
+    }
+    else if (device->deviceType == SDMDeviceType_ArmADI_CoreSightComponent) {
+        encoded->dpIndex = device->armCoreSightComponent.dpIndex;
+        encoded->address = device->armCoreSightComponent.baseAddress;
+        if (device->armCoreSightComponent.memAp != NULL) {
+            encoded->flags = SDMTraceDevice_HasMemAp;
+            encoded->memApAddress = device->armCoreSightComponent.memAp->armAP.address;
+        }
+    }
+}
+
+/*!
+ * @brief Check the header of a trace.
+ *
+ * @param[in] data Pointer to the trace contents.
+ * @param[in] size Size in bytes of the trace contents.
+ * @return The trace header, or NULL if the header is malformed.
+ */
+static inline const SDMTraceFileHeader *SDMTraceCheck(const void *data, size_t size)
+{
+    const SDMTraceFileHeader *header = (const SDMTraceFileHeader *)data;
+    if (data == NULL || size < sizeof(SDMTraceFileHeader)
+            || header->magic != SDMTrace_Magic
+            || header->formatVersion != SDMTrace_FormatVersion
+            || header->headerSize < sizeof(SDMTraceFileHeader)
+            || header->headerSize % SDMTrace_Alignment != 0
+            || header->headerSize > size) {
+        return NULL;
+    }
+    return header;
+}
+
+/*!
+ * @brief Get the record at an offset and advance the offset to the next record.
+ *
+ * Start with _offset_ set to SDMTraceFileHeader::headerSize.
+ *
+ * @param[in] data Pointer to the trace contents, checked with SDMTraceCheck().
+ * @param[in] size Size in bytes of the trace contents.
+ * @param[in,out] offset Offset of the record. Advanced past the record on success.
+ * @return Pointer to the record, or NULL at the end of the trace or if the record is malformed.
+ */
+static inline const SDMTraceRecordHeader *SDMTraceNextRecord(const void *data, size_t size, size_t *offset)
+{
+    if (*offset % SDMTrace_Alignment != 0 || *offset > size || size - *offset < sizeof(SDMTraceRecordHeader)) {
+        return NULL;
+    }
+    const SDMTraceRecordHeader *record = (const SDMTraceRecordHeader *)((const char *)data + *offset);
+    if (record->size < sizeof(SDMTraceRecordHeader) || record->size % SDMTrace_Alignment != 0
+            || record->size > size - *offset) {
+        return NULL;
+    }
+    *offset += record->size;
+    return record;
+}
+
+/*!
+ * @brief Get the payload of a record.
+ *
+ * @param[in] record Record returned by SDMTraceNextRecord().
+ * @param[in] minimumSize Size in bytes of the fixed part of the expected payload.
+ * @return Pointer to the payload, or NULL if the record is smaller than _minimumSize_ bytes of payload.
+ */
+static inline const void *SDMTracePayload(const SDMTraceRecordHeader *record, size_t minimumSize)
+{
+    if (record->size - sizeof(SDMTraceRecordHeader) < minimumSize) {
+        return NULL;
+    }
+    return (const char *)record + sizeof(SDMTraceRecordHeader);
+}
+//@}
+
+/** @} */
+
+#endif /* _SDM_TRACE_H_ */
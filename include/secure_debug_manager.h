@@ -36,6 +36,20 @@
  * debuggers, IDEs, and other tools, for performing protocol-independent secure debug
  * authentication.
  *
+ * @par Threading model
+ *
+ * By default an SDM is not thread safe. The host must not make concurrent calls into the SDM library,
+ * even for different handles.
+ *
+ * If the "thread-safe-handles" feature is enabled in the SDM XML, API calls for different handles may be
+ * made concurrently from different threads. Calls for the same handle must still not overlap, although
+ * successive calls may be made from different threads. The SDM is responsible for protecting any state that
+ * it shares between handles, such as caches.
+ *
+ * The SDM invokes callbacks only from the thread that called the SDM API, and only during that call,
+ * unless the host sets #SDMOpenFlags_ReentrantCallbacks. Asynchronous I/O completion routines are invoked by
+ * the host and follow the rules given for #SDMIOCompletion.
+ *
  * @{
  */
 
@@ -87,7 +101,7 @@ typedef uint8_t SDMBool;
  */
 enum SDMVersionEnum {
     SDMVersion_CurrentMajor = 1, /*!< Current API major version. */
-    SDMVersion_CurrentMinor = 0, /*!< Current API minor version. */
+    SDMVersion_CurrentMinor = 1, /*!< Current API minor version. */
 };
 
 /*!
@@ -106,6 +120,7 @@ enum SDMReturnCodeEnum {
     SDMReturnCode_TransferFault = 9, /*!< Memory or register access failed due to a transfer fault */
     SDMReturnCode_TransferError = 10, /*!< Memory or register access failed due to an error other than a fault */
     SDMReturnCode_InternalError = 11, /*!< An unspecified internal error occurred */
+    SDMReturnCode_WouldBlock = 12, /*!< Operation has not finished and must be continued by a later call. Added in v1.1. */
 };
 
 //! @brief Type for return codes.
@@ -342,6 +357,32 @@ enum SDMTransferSizeEnum {
 //! @brief Memory transfer size parameter type.
 typedef uint32_t SDMTransferSize;
 
+/*!
+ * @brief Memory transfer direction enum.
+ *
+ * These enums are used to specify the direction of an individual #SDMMemoryAccess.
+ */
+enum SDMTransferDirectionEnum {
+    SDMTransferDirection_Read = 1,  //!< Read from target memory.
+    SDMTransferDirection_Write = 2, //!< Write to target memory.
+};
+
+//! @brief Type for memory transfer direction.
+typedef uint32_t SDMTransferDirection;
+
+/*!
+ * @brief Bit masks for sets of transfer sizes.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to describe the set of transfer
+ * sizes supported for an operation, for instance in SDMHostCapabilities::registerTransferSizes. Added in v1.1.
+ */
+enum SDMTransferSizeMaskEnum {
+    SDMTransferSizeMask_8 = (1 << 0),   //!< #SDMTransferSize_8 is supported.
+    SDMTransferSizeMask_16 = (1 << 1),  //!< #SDMTransferSize_16 is supported.
+    SDMTransferSizeMask_32 = (1 << 2),  //!< #SDMTransferSize_32 is supported.
+    SDMTransferSizeMask_64 = (1 << 3),  //!< #SDMTransferSize_64 is supported.
+};
+
 /*!
  * @brief Arm ADI architecture-specific memory transfer attributes.
  *
@@ -432,6 +473,16 @@ enum SDMRegisterAccessOpEnum {
     //!
     //! Repeatedly read register until an expected value or retry limit reached.
     SDMRegisterAccessOp_Poll = 3,
+
+    //! @brief Block write of consecutive elements to a single register. Added in v1.1.
+    //!
+    //! Only valid for #SDMCallbacks::registerAccessEx. Typically used to push data into a FIFO.
+    SDMRegisterAccessOp_WriteBlock = 4,
+
+    //! @brief Block read of consecutive elements from a single register. Added in v1.1.
+    //!
+    //! Only valid for #SDMCallbacks::registerAccessEx. Typically used to drain data from a FIFO.
+    SDMRegisterAccessOp_ReadBlock = 5,
 };
 
 //! @brief Type for register access operation.
@@ -471,6 +522,257 @@ typedef struct SDMRegisterAccess {
     size_t retries;
 } SDMRegisterAccess;
 
+/*!
+ * @brief Flags for extended register accesses.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMRegisterAccessEx::flags field.
+ */
+enum SDMRegisterAccessFlagsEnum {
+    //! @brief Gate each element of a block operation on a status register poll.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_WriteBlock and #SDMRegisterAccessOp_ReadBlock.
+    SDMRegisterAccessFlag_Gated = (1 << 0),
+};
+
+/*!
+ * @brief Details for individual register access with extended options.
+ *
+ * Used with the #SDMCallbacks::registerAccessEx callback. The _address_, _op_, _pollMask_, and _retries_ members have
+ * the same meaning as the members of #SDMRegisterAccess with the same names. Added in v1.1.
+ *
+ * Register values are of the transfer size passed to #SDMCallbacks::registerAccessEx. Masks and match values are
+ * 64 bits wide; for smaller transfer sizes only the low bits are used and the remaining bits must be zero.
+ */
+typedef struct SDMRegisterAccessEx {
+    //! @brief Register address.
+    uint64_t address;
+
+    //! @brief Register access operation.
+    SDMRegisterAccessOp op;
+
+    //! @brief Mask composed of #SDMRegisterAccessFlagsEnum enums.
+    uint32_t flags;
+
+    //! @brief Register value.
+    //!
+    //! Points to an element of the transfer size (`uint8_t`, `uint16_t`, `uint32_t`, or `uint64_t`), or an array
+    //! of such elements, in host byte order.
+    //!
+    //! For #SDMRegisterAccessOp_Read, [out] read value.<br/>
+    //! For #SDMRegisterAccessOp_Write, [in] write value.<br/>
+    //! For #SDMRegisterAccessOp_Poll, [in] poll match value.<br/>
+    //! For #SDMRegisterAccessOp_WriteBlock, [in] array of _count_ elements to write.<br/>
+    //! For #SDMRegisterAccessOp_ReadBlock, [out] array of _count_ elements that receives the read values.
+    //!
+    //! Must not be NULL.
+    void *value;
+
+    //! @brief Poll mask to match regValue.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_Poll, and for gated block operations.
+    uint64_t pollMask;
+
+    //! @brief Poll timeout in microseconds.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_Poll, and for gated block operations.
+    //! Zero indicates no time limit. The timeout is measured from the first poll read.
+    uint64_t pollTimeoutUs;
+
+    //! @brief Minimum interval between poll reads in microseconds.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_Poll, and for gated block operations.
+    //! Zero indicates that the register is read as fast as the probe and interface allow.
+    uint32_t pollIntervalUs;
+
+    //! @brief Reserved for future use. Must be zero.
+    uint32_t reserved;
+
+    //! @brief Poll retry count.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_Poll, and for gated block operations.
+    //! Zero indicates no retry count limit.
+    size_t retries;
+
+    //! @brief Number of elements to transfer.
+    //!
+    //! Only valid for #SDMRegisterAccessOp_WriteBlock and #SDMRegisterAccessOp_ReadBlock.
+    size_t count;
+
+    //! @brief Address of the status register polled before each element of a gated block operation.
+    //!
+    //! Only valid if #SDMRegisterAccessFlag_Gated is set.
+    uint64_t gateAddress;
+
+    //! @brief Value to match for the status register poll of a gated block operation.
+    //!
+    //! Only valid if #SDMRegisterAccessFlag_Gated is set. The status register value is ANDed with _pollMask_
+    //! and compared with this value.
+    uint64_t gateValue;
+} SDMRegisterAccessEx;
+
+/*!
+ * @brief Details for an individual memory transfer within a batch.
+ *
+ * Used with the #SDMCallbacks::transferMemoryBatch callback. Each descriptor has the same meaning as the
+ * parameters of the #SDMCallbacks::readMemory or #SDMCallbacks::writeMemory callback, selected by the
+ * _direction_ field.
+ */
+typedef struct SDMMemoryAccess {
+    //! @brief Pointer to descriptor for device through which the transfer will be performed.
+    const struct SDMDeviceDescriptor *device;
+
+    //! @brief Memory address of the data to transfer.
+    uint64_t address;
+
+    //! @brief Enum indicating the requested size of the transfer unit.
+    SDMTransferSize transferSize;
+
+    //! @brief Direction of the transfer, one of the #SDMTransferDirectionEnum enumerators.
+    SDMTransferDirection direction;
+
+    //! @brief Number of memory elements of size _transferSize_ to transfer.
+    size_t transferCount;
+
+    //! @brief Debug-architecture-defined transfer attributes.
+    //!
+    //! For Arm ADI, this is a value produced by OR'ing the enums defined in #SDMArmADITransferAttributesEnum.
+    uint32_t attributes;
+
+    //! @brief Transfer data buffer.
+    //!
+    //! For #SDMTransferDirection_Read, [out] buffer where read data will be written.<br/>
+    //! For #SDMTransferDirection_Write, [in] buffer from where data to be written is read.
+    //!
+    //! Must be at least _transferSize_ * _transferCount_ bytes in length. Must not be NULL.
+    void *data;
+} SDMMemoryAccess;
+
+//! @brief Token identifying an outstanding asynchronous I/O request.
+//!
+//! Tokens are assigned by the host when an asynchronous callback successfully queues a request. A token is
+//! unique among the requests outstanding for an SDM instance, and may be reused once the request's completion
+//! routine has been invoked.
+typedef uint64_t SDMRequestToken;
+
+/*!
+ * @brief Completion routine for asynchronous I/O requests.
+ *
+ * The completion routine is provided by the SDM when it calls one of the asynchronous I/O callbacks, such as
+ * #SDMCallbacks::readMemoryAsync. The host invokes it exactly once for each successfully queued request.
+ *
+ * The routine may be invoked on any host thread, and may be invoked before the asynchronous callback that
+ * queued the request has returned. The SDM must not call any other SDM callback from within the completion
+ * routine, except other asynchronous I/O callbacks.
+ *
+ * @param[in] token The token that was assigned to the request.
+ * @param[in] result Result of the request; the same set of values as for the equivalent blocking callback.
+ * @param[in] completedCount For register accesses, the number of register accesses completed. For memory
+ *  transfers, the number of memory elements transferred.
+ * @param[in] context The _completionContext_ value passed to the asynchronous callback.
+ */
+typedef void (*SDMIOCompletion)(SDMRequestToken token, SDMReturnCode result, size_t completedCount, void *context);
+
+//! @brief Handle to a host write stream opened with #SDMCallbacks::openWriteStream.
+typedef struct _SDMWriteStreamOpaque *SDMWriteStream;
+
+/*!
+ * @brief Flags for #SDMCallbacks::writeStreamChunk.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together.
+ */
+enum SDMWriteChunkFlagsEnum {
+    //! @brief Do not wait for space in the host's queue.
+    //!
+    //! If the queue is full, the callback returns #SDMReturnCode_WouldBlock without accepting the chunk.
+    SDMWriteChunk_NoWait = (1 << 0),
+};
+
+/*!
+ * @brief Flags for #SDMCallbacks::beginTransactionGroup.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together.
+ */
+enum SDMTransactionGroupFlagsEnum {
+    //! @brief Perform all accesses of the group in call order, including accesses through different devices.
+    SDMTransactionGroup_Ordered = (1 << 0),
+};
+
+/*!
+ * @brief Memory region kinds for #SDMCallbacks::declareMemoryRegion.
+ */
+enum SDMMemoryRegionKindEnum {
+    //! @brief Contents do not change until the target is reset, such as ROM tables and CoreSight ID registers.
+    SDMMemoryRegion_Immutable = 1,
+
+    //! @brief Contents may change at any time, such as status registers. Never cached.
+    SDMMemoryRegion_Volatile = 2,
+};
+
+//! @brief Type for memory region kind.
+typedef uint32_t SDMMemoryRegionKind;
+
+/*!
+ * @brief Authentication phases.
+ *
+ * Protocol-independent phases of an authentication, used to attribute time in #SDMStatistics and
+ * #SDMProgressEvent. Not every protocol has every phase. Added in v1.1.
+ */
+enum SDMPhaseEnum {
+    SDMPhase_Other = 0,                 //!< Time not attributed to one of the other phases.
+    SDMPhase_Discovery = 1,             //!< Locating the debug mailbox and other target resources.
+    SDMPhase_CredentialLoad = 2,        //!< Loading and decoding credentials, such as keys and certificates.
+    SDMPhase_ChallengeRequest = 3,      //!< Requesting and receiving the challenge from the target.
+    SDMPhase_Signature = 4,             //!< Computing the response signature.
+    SDMPhase_CertificateTransfer = 5,   //!< Sending certificates and the signed response to the target.
+    SDMPhase_Response = 6,              //!< Waiting for and receiving the target's authentication result.
+    SDMPhase_ResumeBoot = 7,            //!< Performing SDMResumeBoot().
+    SDMPhase_Reset = 8,                 //!< Waiting for a target reset to complete, excluding overlapped work.
+};
+
+//! @brief Type for authentication phase.
+typedef uint32_t SDMPhase;
+
+/*!
+ * @brief Progress event types.
+ */
+enum SDMProgressEventTypeEnum {
+    SDMProgressEvent_PhaseBegin = 1,    //!< The phase has started.
+    SDMProgressEvent_PhaseEnd = 2,      //!< The phase has finished, successfully or not.
+    SDMProgressEvent_Update = 3,        //!< Progress within the phase, for instance after each message.
+};
+
+//! @brief Type for progress event type.
+typedef uint32_t SDMProgressEventType;
+
+/*!
+ * @brief Structured progress event.
+ *
+ * Passed to #SDMCallbacks::reportProgressEvent. Added in v1.1.
+ *
+ * Phases do not nest. A #SDMProgressEvent_PhaseBegin event for one phase implies the end of any phase that has
+ * not been ended, so hosts can compute phase durations from consecutive events. Byte counts are cumulative from
+ * the start of the phase, so that the #SDMProgressEvent_PhaseEnd event holds the phase totals.
+ */
+typedef struct SDMProgressEvent {
+    SDMProgressEventType type;  //!< Event type.
+    SDMPhase phase;             //!< Phase to which the event applies.
+
+    //! @brief Time of the event in nanoseconds, from a monotonic clock.
+    //!
+    //! The clock is the platform's monotonic clock, such as `CLOCK_MONOTONIC` on POSIX or
+    //! `QueryPerformanceCounter()` on Windows. Only differences between timestamps are meaningful.
+    uint64_t timestampNs;
+
+    uint64_t bytesSent;         //!< Protocol message bytes sent to the target since the start of the phase.
+    uint64_t bytesReceived;     //!< Protocol message bytes received from the target since the start of the phase.
+
+    //! @brief Device being authenticated, for SDMAuthenticateDevices(). NULL for SDMAuthenticate().
+    const SDMDeviceDescriptor *device;
+
+    uint8_t percentComplete;    //!< Overall progress of the operation, from 0 to 100.
+} SDMProgressEvent;
+
 /*!
  * @brief Collection of common callback functions provided by the debugger.
  *
@@ -483,6 +785,17 @@ typedef struct SDMRegisterAccess {
  *
  * For minor version API increments to remain backwards compatible, new callbacks must be added to the
  * end of this struct.
+ *
+ * Callbacks added in a minor version increment are optional. Before using such a callback, the SDM must
+ * check that the SDMOpenParameters::version passed to SDMOpen() is at least the version that introduced
+ * the callback, and that the callback pointer is not NULL. Hosts that do not implement an optional
+ * callback must set it to NULL. The SDM must fall back to the v1.0 callbacks in either case.
+ *
+ * The same rule applies to members added in a minor version increment to the end of other structs passed by
+ * the host that have no size field, such as #SDMOpenParameters and #SDMAuthenticateParameters. A host built
+ * for an earlier version passes the smaller struct, so the SDM must only read such a member if
+ * SDMOpenParameters::version is at least the version that introduced it, and must otherwise behave as if the
+ * member were zero or NULL.
  */
 typedef struct SDMCallbacks {
     //! @brief Debug architecture-specific callbacks. Reserved for future use.
@@ -498,6 +811,10 @@ typedef struct SDMCallbacks {
      *
      * Host support for reporting progress is optional.
      *
+     * If the host provides #SDMCallbacks::reportProgressEvent, the SDM should report phase changes through it
+     * and use this callback only for messages that carry information not in the events. The host can derive
+     * display text from the event phases.
+     *
      * @param[in] progressMessage
      * @param[in] percentComplete
      * @param[in] refcon Must be set to the reference value provided by the debugger through
@@ -521,6 +838,12 @@ typedef struct SDMCallbacks {
     //@}
 
     //! @name Target reset
+    //!
+    //! If the host sets #SDMHostCapability_OverlappedReset, #SDMCallbacks::resetStart starts the whole reset
+    //! sequence and returns without waiting for the target, and #SDMCallbacks::resetFinish waits until the target
+    //! has left reset and is accessible. Between the two callbacks, the SDM may perform work that does not access
+    //! the target, such as loading credentials, and that work then overlaps the reset latency. The SDM must not
+    //! call memory or register access callbacks between the two callbacks.
     //@{
     /*!
      * @brief Reset assertion stage.
@@ -643,10 +966,11 @@ typedef struct SDMCallbacks {
      * For poll operations, the indicated register is repeatedly read as fast as the probe and interface allow.
      * Each read value is ANDed with SDMRegisterAccess::pollMask and the result compared with
      * *SDMRegisterAccess::value. If the comparison is a match, polling stops and the access sequence moves to
-     * the next operation (or terminates).
+     * the next operation (or terminates). Use #SDMCallbacks::registerAccessEx, if available, to bound polls by
+     * time instead of by retry count.
      *
-     * All register reads and writes are of the same size, specified by the _transferSize_ parameter. In v1.0 of
-     * the SDM API, only 32-bit transfers (#SDMTransferSize_32) are allowed.
+     * All register reads and writes are of the same size, specified by the _transferSize_ parameter. Only 32-bit
+     * transfers (#SDMTransferSize_32) are allowed. Other sizes are available through #SDMCallbacks::registerAccessEx.
      *
      * The _device_ parameter must be a pointer to a device descriptor of valid type as defined by the
      * debug architecture.
@@ -731,6 +1055,13 @@ typedef struct SDMCallbacks {
      * The intended use cases include selecting a credential or other configuration item, enter username
      * and/or password, select files, set requested permissions, and so on.
      *
+     * Before presenting a form, the SDM fills in the initial value of each element from, in priority order, the
+     * matching entry of SDMOpenParameters::formAnswers, then the value returned by
+     * #SDMCallbacks::loadFormValue for elements with #SDMForm_IsCacheable set. If every element that is not
+     * static text, hidden, or optional has a value from one of these sources, the SDM does not call this
+     * callback and proceeds as if the user accepted the form. After the user completes a form, the SDM passes
+     * the value of each cacheable element to #SDMCallbacks::storeFormValue.
+     *
      * @param[in] form Pointer to the form descriptor struct.
      * @param[in] refcon Must be set to the reference value provided by the debugger through
      *  SDMOpenParameters::refcon.
@@ -742,73 +1073,976 @@ typedef struct SDMCallbacks {
     SDMReturnCode (*presentForm)(const SDMForm *form, void *refcon);
     //@}
 
-} SDMCallbacks;
-
-/*!
- * @brief Debugger connection modes.
- */
-enum SDMConnectModeEnum {
-    //! @brief Connect in order to load application into memory before running.
+    //! @name Batched memory accesses
     //!
-    //! When the SDM authenticates, the application that will be debugged has not yet been loaded.
-    SDMConnectMode_Load = 0,
+    //! Added in SDM API v1.1. Optional; may be NULL.
+    //@{
+    /*!
+     * @brief Perform a series of memory transfers.
+     *
+     * A sequence of zero or more memory reads and writes is performed in the order specified. Each transfer
+     * may target a different device, address, transfer size, and set of attributes. The rules for the _device_
+     * and _address_ values are the same as for the #SDMCallbacks::readMemory and #SDMCallbacks::writeMemory
+     * callbacks.
+     *
+     * The purpose of this callback is to allow the host to send the complete set of transfers to the debug
+     * probe as a single transaction, instead of incurring one host to probe round trip per transfer. Hosts
+     * without support for queued transfers may implement this by performing each transfer in turn.
+     *
+     * Transfers are performed in order. If a transfer fails, no later transfers are performed, and
+     * _accessesCompleted_ is set to the index of the failed transfer. Data for a read transfer is only valid
+     * if the transfer completed.
+     *
+     * The SDM must not depend on the data of a read within the batch having been written to its buffer before
+     * a later transfer in the same batch is started. That is, the batch cannot be used to write a value that
+     * was read by an earlier transfer in the same batch.
+     *
+     * @param[in,out] accesses Array of SDMMemoryAccess memory transfer descriptors.
+     * @param[in] accessCount Number of memory transfers. The _accesses_ parameter must point to an array
+     *  containing at least this number of elements. A value of zero is allowed, and results in no operation.
+     * @param[out] accessesCompleted Number of memory transfers completed. On success this will equal accessCount.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success All transfers completed.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_TransferFault
+     * @retval SDMReturnCode_TransferError
+     * @retval SDMReturnCode_UnsupportedTransferSize
+     * @retval SDMReturnCode_TimeoutError
+     */
+    SDMReturnCode (*transferMemoryBatch)(
+        const SDMMemoryAccess *accesses,
+        size_t accessCount,
+        size_t *accessesCompleted,
+        void *refcon);
+    //@}
 
-    //! @brief Connect and reset to run previously loaded application.
+    //! @name Asynchronous I/O
     //!
-    //! When the SDM authenticates, the application that will be debugged has already been loaded.
-    SDMConnectMode_Restart = 1,
-
-    //! @brief Attach to running application.
+    //! Added in SDM API v1.1. Optional; may be NULL.
     //!
-    //! The SDM should not reset the target.
-    SDMConnectMode_Attach = 2,
-};
-
-//! @brief Type for default device type enum parameter.
-typedef uint32_t SDMConnectMode;
+    //! These callbacks are non-blocking variants of the memory and register access callbacks. Each callback
+    //! queues a request with the host and returns as soon as the request is accepted. The host reports completion
+    //! by invoking the SDM-provided #SDMIOCompletion routine. This allows the SDM to have several requests
+    //! outstanding at once, and allows a host to service many SDM instances without a thread per instance.
+    //!
+    //! The asynchronous callbacks are only used if the host sets #SDMOpenFlags_AsyncIO in
+    //! SDMOpenParameters::flags. Hosts that set this flag must implement all of the callbacks in this group.
+    //!
+    //! When a callback returns #SDMReturnCode_Success, the request has been queued and the completion routine
+    //! will be invoked exactly once. Any other return value means that the request was not queued and the
+    //! completion routine will not be invoked. All buffers and descriptors passed to a queued request must remain
+    //! valid until its completion routine is invoked.
+    //!
+    //! Requests for the same device are performed in the order they are queued. There is no ordering guarantee
+    //! between requests for different devices.
+    //!
+    //! An SDM must not return from SDMAuthenticate() or SDMClose() while any of its requests are outstanding.
+    //@{
+    /*!
+     * @brief Queue a target memory read.
+     *
+     * Parameters are the same as for #SDMCallbacks::readMemory, except as noted.
+     *
+     * @param[in] completion Routine invoked by the host when the request completes. Must not be NULL.
+     * @param[in] completionContext SDM-defined value passed to the completion routine.
+     * @param[out] token Set to the token assigned to the request, if it was queued. Must not be NULL.
+     *
+     * @retval SDMReturnCode_Success The request was queued.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_RequestFailed The request could not be queued.
+     */
+    SDMReturnCode (*readMemoryAsync)(
+        const SDMDeviceDescriptor *device,
+        uint64_t address,
+        SDMTransferSize transferSize,
+        size_t transferCount,
+        uint32_t attributes,
+        void *data,
+        SDMIOCompletion completion,
+        void *completionContext,
+        SDMRequestToken *token,
+        void *refcon);
 
-/*!
- * @brief Parameters passed to SDMOpen() by the debugger.
- */
-typedef struct SDMOpenParameters {
-    struct {
-        uint16_t major; /*!< Client interface major version. */
-        uint16_t minor; /*!< Client interface minor version. */
-    } version; /*!< Client interface version. @see #SDMVersionEnum. */
-    SDMDebugArchitecture debugArchitecture; /*!< Debug architecture for the target. */
-    SDMCallbacks *callbacks; /*!< Callback collection */
-    void *refcon; /*!< Debugger-supplied value passed to each of the callbacks. */
-    const char *resourcesDirectoryPath; /*!< Absolute path to the directory containing the SDM plugin's resources. */
-    const char *manifestFilePath; /*!< Absolute path to the manifest XML file. */
-    uint32_t flags; /*!< Flags passed to the SDM from the debugger. Reserved for future use. */
-    const char **locales; /*!< Pointer to a NULL-terminated array of IETF BCP 47 language tags, e.g. "en-US", "fr-FR", "sv", etc. The  tags are sorted in decreasing priority order. */
-    SDMConnectMode connectMode; /*!< Debugger connect mode. */
-} SDMOpenParameters;
+    /*!
+     * @brief Queue a target memory write.
+     *
+     * Parameters are the same as for #SDMCallbacks::writeMemory, except as noted.
+     *
+     * @param[in] completion Routine invoked by the host when the request completes. Must not be NULL.
+     * @param[in] completionContext SDM-defined value passed to the completion routine.
+     * @param[out] token Set to the token assigned to the request, if it was queued. Must not be NULL.
+     *
+     * @retval SDMReturnCode_Success The request was queued.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_RequestFailed The request could not be queued.
+     */
+    SDMReturnCode (*writeMemoryAsync)(
+        const SDMDeviceDescriptor *device,
+        uint64_t address,
+        SDMTransferSize transferSize,
+        size_t transferCount,
+        uint32_t attributes,
+        const void *value,
+        SDMIOCompletion completion,
+        void *completionContext,
+        SDMRequestToken *token,
+        void *refcon);
 
-/*!
- * @brief Parameters passed by the debugger to the SDMAuthenticate() API.
- */
-typedef struct SDMAuthenticateParameters {
-    SDMBool isLastAuthentication; //!< False if at least one subsequent call to SDMAuthenticate() is expected.
-} SDMAuthenticateParameters;
+    /*!
+     * @brief Queue a series of device register accesses.
+     *
+     * Parameters are the same as for #SDMCallbacks::registerAccess, except as noted. The number of accesses
+     * completed is passed to the completion routine.
+     *
+     * @param[in] completion Routine invoked by the host when the request completes. Must not be NULL.
+     * @param[in] completionContext SDM-defined value passed to the completion routine.
+     * @param[out] token Set to the token assigned to the request, if it was queued. Must not be NULL.
+     *
+     * @retval SDMReturnCode_Success The request was queued.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_RequestFailed The request could not be queued.
+     */
+    SDMReturnCode (*registerAccessAsync)(
+        const SDMDeviceDescriptor *device,
+        SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses,
+        size_t accessCount,
+        SDMIOCompletion completion,
+        void *completionContext,
+        SDMRequestToken *token,
+        void *refcon);
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+    /*!
+     * @brief Request cancellation of an outstanding asynchronous request.
+     *
+     * Cancellation is a request only. The completion routine is still invoked for the cancelled request, with
+     * a result of #SDMReturnCode_UserCancelled if it was cancelled before completing, otherwise with the
+     * normal result.
+     *
+     * @param[in] token Token of the request to cancel.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The cancellation request was accepted.
+     * @retval SDMReturnCode_InvalidArgument The token does not identify an outstanding request.
+     */
+    SDMReturnCode (*cancelAsyncRequest)(SDMRequestToken token, void *refcon);
+    //@}
 
-//! @name API
-//@{
-/*!
- * @brief This function is called by the debugger to start a secure debug session with the remote platform.
- *
- * @param[out] handle New handle to the SDM instance.
- * @param[in] params Connection details and callbacks. This pointer and all nested pointers will remain valid
- *  until SDMClose() is called, so the plugin can cache the value for later use without having to copy all
- *  the data.
- *
- * @retval SDMReturnCode_Success SDM plugin initialized successfully.
- * @retval SDMReturnCode_RequestFailed
- */
+    //! @name Extended register accesses
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL.
+    //@{
+    /*!
+     * @brief Perform a series of device register accesses with extended options.
+     *
+     * This callback behaves the same as #SDMCallbacks::registerAccess, except that accesses are described by
+     * #SDMRegisterAccessEx, which adds the following for poll operations:
+     *
+     * - A timeout in wall-clock time, SDMRegisterAccessEx::pollTimeoutUs. If both a timeout and a retry count are
+     *      specified, polling stops with #SDMReturnCode_TimeoutError when either limit is reached. At least one
+     *      read is always performed.
+     * - A minimum interval between poll reads, SDMRegisterAccessEx::pollIntervalUs. The host or probe may read
+     *      less often than requested, but not more often.
+     *
+     * Expressing polls in time units makes them behave the same regardless of the speed of the probe. If the
+     * host sets #SDMHostCapability_ProbePolling, poll loops run in the debug probe and do not cost a host to
+     * probe round trip per read, so the SDM should prefer a single long poll to repeated short polls.
+     *
+     * Block operations, #SDMRegisterAccessOp_WriteBlock and #SDMRegisterAccessOp_ReadBlock, transfer
+     * SDMRegisterAccessEx::count elements between a contiguous buffer and a single register, so that streaming a
+     * payload through a FIFO does not require one descriptor per element. If #SDMRegisterAccessFlag_Gated is set,
+     * a poll of the register at SDMRegisterAccessEx::gateAddress precedes each element, using _pollMask_,
+     * _gateValue_, and the poll timeout, interval, and retry limits of the descriptor. If any gate poll or element
+     * transfer fails, the block operation fails and the number of elements transferred is unspecified. Hosts can use probe block
+     * transfer or FIFO modes to perform these operations.
+     *
+     * Register accesses may be 8, 16, 32, or 64 bits wide, as allowed by the debug architecture for the device.
+     * The sizes supported by the host are given by SDMHostCapabilities::registerTransferSizes; if this is zero,
+     * or no host capabilities were provided, only #SDMTransferSize_32 is supported.
+     *
+     * @param[in] device Pointer to descriptor for device through which the accesses will be performed.
+     * @param[in] transferSize The size of all register accesses in this call.
+     * @param[in,out] accesses Array of SDMRegisterAccessEx register accesses descriptors.
+     * @param[in] accessCount Number of register accesses. A value of zero is allowed, and results in no operation.
+     * @param[out] accessesCompleted Number of register accesses completed. On success this will equal accessCount.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success Transfer completed.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_TransferFault
+     * @retval SDMReturnCode_TransferError
+     * @retval SDMReturnCode_UnsupportedTransferSize
+     * @retval SDMReturnCode_TimeoutError
+     */
+    SDMReturnCode (*registerAccessEx)(
+        const SDMDeviceDescriptor *device,
+        SDMTransferSize transferSize,
+        const SDMRegisterAccessEx *accesses,
+        size_t accessCount,
+        size_t *accessesCompleted,
+        void *refcon);
+    //@}
+
+    //! @name Transfer buffers
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL. Hosts must implement both or neither.
+    //!
+    //! These callbacks let the SDM use buffers from the host's I/O buffer pool, for instance buffers registered
+    //! with a network probe's driver or suitable for DMA. When a buffer obtained from
+    //! #SDMCallbacks::acquireTransferBuffer is passed as the data buffer of a memory transfer, a block register
+    //! operation, or a batched or asynchronous transfer, the host may transfer directly to or from it instead of
+    //! copying the data. Passing any other buffer remains valid but may require copies.
+    //@{
+    /*!
+     * @brief Obtain a transfer buffer from the host.
+     *
+     * The returned buffer is aligned to at least SDMHostCapabilities::transferBufferAlignment bytes, or to 8
+     * bytes if no host capabilities were provided. It remains owned by the SDM until it is passed to
+     * #SDMCallbacks::releaseTransferBuffer. All transfer buffers must be released before SDMClose() returns.
+     *
+     * @param[in] size Required size of the buffer in bytes. Must be greater than 0.
+     * @param[out] buffer Set to the address of the buffer on success, or to NULL on failure.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The buffer was allocated.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_RequestFailed No buffer of the requested size is available. The SDM should fall back
+     *  to its own buffers.
+     */
+    SDMReturnCode (*acquireTransferBuffer)(size_t size, void **buffer, void *refcon);
+
+    /*!
+     * @brief Return a transfer buffer to the host.
+     *
+     * The buffer must not be in use by an outstanding asynchronous request.
+     *
+     * @param[in] buffer Buffer previously returned by #SDMCallbacks::acquireTransferBuffer.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     */
+    void (*releaseTransferBuffer)(void *buffer, void *refcon);
+    //@}
+
+    //! @name Form value cache
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL. Hosts must implement both or neither.
+    //!
+    //! These callbacks give the SDM a persistent, host-managed store of the values of elements with the
+    //! #SDMForm_IsCacheable flag, so that a form does not have to be presented again on the next run. Values
+    //! are identified by the form and element IDs. The host must keep a separate cache for each SDM library,
+    //! for instance by keying on SDMOpenParameters::manifestFilePath. Values use the text encoding described
+    //! for #SDMFormAnswer.
+    //@{
+    /*!
+     * @brief Retrieve a cached form element value.
+     *
+     * @param[in] formId SDMForm::id of the form.
+     * @param[in] elementId SDMFormElement::id of the element.
+     * @param[out] buffer Buffer that receives the null-terminated, UTF-8 encoded value.
+     * @param[in] bufferLength Size in bytes of _buffer_.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The value was copied to _buffer_.
+     * @retval SDMReturnCode_InvalidArgument The buffer is too small for the cached value.
+     * @retval SDMReturnCode_RequestFailed No value is cached for the element.
+     */
+    SDMReturnCode (*loadFormValue)(
+        const char *formId,
+        const char *elementId,
+        char *buffer,
+        size_t bufferLength,
+        void *refcon);
+
+    /*!
+     * @brief Save a form element value in the cache.
+     *
+     * Replaces any value previously cached for the element. The host may decline to store the value, for
+     * instance if the element also has the #SDMForm_IsPassword flag and the host has no secure storage.
+     *
+     * @param[in] formId SDMForm::id of the form.
+     * @param[in] elementId SDMFormElement::id of the element.
+     * @param[in] value Null-terminated, UTF-8 encoded value.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The value was stored or declined.
+     * @retval SDMReturnCode_RequestFailed The cache could not be written.
+     */
+    SDMReturnCode (*storeFormValue)(const char *formId, const char *elementId, const char *value, void *refcon);
+    //@}
+
+    //! @name Progress events
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL.
+    //@{
+    /*!
+     * @brief Report a structured progress event.
+     *
+     * Informs the host of authentication phase changes without formatting text, so that hosts can aggregate
+     * timing across many sessions. The same restrictions apply as for #SDMCallbacks::updateProgress. The SDM
+     * must report at least a #SDMProgressEvent_PhaseBegin and a #SDMProgressEvent_PhaseEnd event for each phase
+     * that it performs. Hosts must return quickly from this callback.
+     *
+     * @param[in] event The event. Only valid for the duration of the call.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     */
+    void (*reportProgressEvent)(const SDMProgressEvent *event, void *refcon);
+    //@}
+
+    //! @name Memory read cache
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL. Hosts must implement both or neither.
+    //!
+    //! These callbacks let the SDM tell the host which target memory may be cached, so that repeated reads of
+    //! the same ROM tables and ID registers during discovery do not each cost a link round trip. A host that
+    //! caches reads sets #SDMHostCapability_ReadCache.
+    //!
+    //! The host may satisfy a memory read from its cache if the whole read lies within a region declared
+    //! #SDMMemoryRegion_Immutable for the same device and transfer attributes. Device descriptors are compared by
+    //! value, including the MEM-AP descriptor of a CoreSight component. Reads of any other memory, and reads that
+    //! fail, are not cached. Writes always go to the target, and discard cached data for the bytes written.
+    //!
+    //! All cached data, but not the region declarations, is discarded when #SDMCallbacks::resetStart is called,
+    //! and when SDMReattach() is called. Region declarations are discarded by SDMClose().
+    //@{
+    /*!
+     * @brief Declare whether a target memory region may be cached.
+     *
+     * A later declaration replaces earlier declarations for the bytes it covers. Declaring a region
+     * #SDMMemoryRegion_Volatile also discards cached data for it.
+     *
+     * @param[in] device Pointer to descriptor for device through which the region is accessed.
+     * @param[in] address Start address of the region, with the same meaning as for #SDMCallbacks::readMemory.
+     * @param[in] size Size of the region in bytes. Must be greater than 0.
+     * @param[in] attributes Transfer attributes of the reads to which the declaration applies.
+     * @param[in] kind One of the #SDMMemoryRegionKindEnum enumerators.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The declaration was recorded, or the host does not cache reads.
+     * @retval SDMReturnCode_InvalidArgument
+     */
+    SDMReturnCode (*declareMemoryRegion)(
+        const SDMDeviceDescriptor *device,
+        uint64_t address,
+        uint64_t size,
+        uint32_t attributes,
+        SDMMemoryRegionKind kind,
+        void *refcon);
+
+    /*!
+     * @brief Discard cached memory contents.
+     *
+     * Used when the SDM knows that target memory has changed in a way the host cannot see, for instance
+     * after the target has processed an authentication response.
+     *
+     * @param[in] device Pointer to descriptor for the device whose cached data is discarded, or NULL to discard
+     *  all cached data.
+     * @param[in] address Start address of the range to discard. Ignored if _device_ is NULL.
+     * @param[in] size Size of the range in bytes, or 0 for all cached data of the device. Ignored if _device_ is
+     *  NULL.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     */
+    void (*invalidateMemoryCache)(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size, void *refcon);
+    //@}
+
+    //! @name Streaming memory writes
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL. Hosts must implement all three or none.
+    //!
+    //! A write stream writes a payload to consecutive target addresses in chunks, so that the SDM can produce
+    //! the payload incrementally, for instance hashing or signing it on the fly, while the host and probe are
+    //! still writing earlier chunks. The host queues accepted chunks and writes them in order. The preferred
+    //! chunk size and the queue depth are given by SDMHostCapabilities::preferredWriteChunkSize and
+    //! SDMHostCapabilities::writeStreamQueueDepth.
+    //!
+    //! Accesses made by other callbacks while a stream is open are not ordered with respect to the stream's
+    //! queued chunks, except that #SDMCallbacks::closeWriteStream returns only after all chunks are written.
+    //@{
+    /*!
+     * @brief Open a write stream.
+     *
+     * @param[in] device Pointer to descriptor for device through which the writes will be performed.
+     * @param[in] address Target address of the first byte of the payload. Must be aligned to _transferSize_.
+     * @param[in] transferSize Size of the individual writes.
+     * @param[in] attributes Transfer attributes, as for #SDMCallbacks::writeMemory.
+     * @param[in] totalSize Size in bytes of the whole payload if known, otherwise 0. Lets the host prepare.
+     * @param[out] stream Set to the stream handle on success.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The stream was opened.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_UnsupportedTransferSize
+     * @retval SDMReturnCode_RequestFailed No more streams can be opened.
+     */
+    SDMReturnCode (*openWriteStream)(
+        const SDMDeviceDescriptor *device,
+        uint64_t address,
+        SDMTransferSize transferSize,
+        uint32_t attributes,
+        uint64_t totalSize,
+        SDMWriteStream *stream,
+        void *refcon);
+
+    /*!
+     * @brief Queue the next chunk of a write stream.
+     *
+     * The chunk is written at the address following the previous chunk. When this callback returns, the host has
+     * either written or copied the chunk, so the SDM may reuse the buffer, unless the buffer was obtained from
+     * #SDMCallbacks::acquireTransferBuffer, in which case the host may use it in place until the stream is closed.
+     *
+     * Errors of earlier chunks are returned by a later call of this callback or by #SDMCallbacks::closeWriteStream.
+     * After an error, the stream accepts no more chunks and must be closed.
+     *
+     * @param[in] stream Stream handle.
+     * @param[in] data Chunk data.
+     * @param[in] size Size in bytes of the chunk. Must be a multiple of the stream's transfer size.
+     * @param[in] flags Mask composed of #SDMWriteChunkFlagsEnum enums.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The chunk was accepted.
+     * @retval SDMReturnCode_WouldBlock #SDMWriteChunk_NoWait was set and the queue is full. The chunk was not
+     *  accepted; the SDM may do other work and pass it again later.
+     * @retval SDMReturnCode_InvalidArgument
+     * @retval SDMReturnCode_TransferFault
+     * @retval SDMReturnCode_TransferError
+     */
+    SDMReturnCode (*writeStreamChunk)(
+        SDMWriteStream stream,
+        const void *data,
+        size_t size,
+        uint32_t flags,
+        void *refcon);
+
+    /*!
+     * @brief Close a write stream.
+     *
+     * Waits until all accepted chunks have been written, unless _abort_ is true, in which case chunks not yet
+     * written are discarded. The stream handle is invalid after this callback returns.
+     *
+     * @param[in] stream Stream handle.
+     * @param[in] abort If true, discard chunks not yet written.
+     * @param[out] bytesWritten Set to the number of payload bytes written to the target. May be NULL.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success All accepted chunks were written, or the stream was aborted.
+     * @retval SDMReturnCode_TransferFault
+     * @retval SDMReturnCode_TransferError
+     */
+    SDMReturnCode (*closeWriteStream)(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten, void *refcon);
+    //@}
+
+    //! @name Transaction groups
+    //!
+    //! Added in SDM API v1.1. Optional; may be NULL. Hosts must implement both or neither.
+    //!
+    //! A transaction group lets the host collect a sequence of #SDMCallbacks::readMemory,
+    //! #SDMCallbacks::writeMemory, #SDMCallbacks::registerAccess, #SDMCallbacks::registerAccessEx, and
+    //! #SDMCallbacks::transferMemoryBatch calls and send them to the probe as one command list. The host can
+    //! then merge the AP and DP setup, such as CSW and TAR writes, that the calls have in common. A host that
+    //! coalesces groups sets #SDMHostCapability_TransactionGroups.
+    //!
+    //! Within a group, the following rules apply:
+    //!
+    //! - The host may defer each access until #SDMCallbacks::commitTransactionGroup. A deferred call returns
+    //!     #SDMReturnCode_Success if its arguments are valid; transfer errors are returned by the commit.
+    //! - Data to be written is copied by the host when the call is made, so the SDM may reuse write buffers at
+    //!     once. Read buffers, read register values, and _accessesCompleted_ counts are only valid after the
+    //!     commit returns. The SDM therefore cannot use a value read within a group to compute a later access in
+    //!     the same group; poll operations are the way to wait on target state.
+    //! - Accesses through the same device are performed in call order. Accesses through different devices may be
+    //!     reordered with respect to each other, unless #SDMTransactionGroup_Ordered is set. A register access
+    //!     and a memory access are through the same device if they use the same AP, or the same MEM-AP for a
+    //!     CoreSight component.
+    //! - The host may merge accesses, for instance adjacent memory reads into one block read, as long as the
+    //!     values read and written on the target are the same as for the individual accesses.
+    //! - A host that performs accesses at call time instead of deferring them returns their results at once.
+    //!     If an access fails, the host need not perform the accesses that follow it in the group.
+    //! - Groups do not nest. The SDM must not call any callbacks other than the ones listed above, except
+    //!     #SDMCallbacks::updateProgress and #SDMCallbacks::reportProgressEvent, between the begin and the commit.
+    //@{
+    /*!
+     * @brief Start a transaction group.
+     *
+     * @param[in] flags Mask composed of #SDMTransactionGroupFlagsEnum enums.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success The group was started.
+     * @retval SDMReturnCode_InvalidArgument A group is already open.
+     */
+    SDMReturnCode (*beginTransactionGroup)(uint32_t flags, void *refcon);
+
+    /*!
+     * @brief Perform the accesses of a transaction group and end the group.
+     *
+     * Returns when all accesses of the group have been performed, or one has failed.
+     *
+     * @param[out] callsCompleted Set to the number of calls in the group that completed successfully, in call
+     *  order. May be NULL.
+     * @param[in] refcon Must be set to the reference value provided by the debugger through
+     *  SDMOpenParameters::refcon.
+     *
+     * @retval SDMReturnCode_Success All accesses succeeded.
+     * @retval SDMReturnCode_InvalidArgument No group is open.
+     * @return Otherwise, the result of the first access that failed, with the same values as the failing callback.
+     */
+    SDMReturnCode (*commitTransactionGroup)(size_t *callsCompleted, void *refcon);
+    //@}
+
+} SDMCallbacks;
+
+/*!
+ * @brief Debugger connection modes.
+ */
+enum SDMConnectModeEnum {
+    //! @brief Connect in order to load application into memory before running.
+    //!
+    //! When the SDM authenticates, the application that will be debugged has not yet been loaded.
+    SDMConnectMode_Load = 0,
+
+    //! @brief Connect and reset to run previously loaded application.
+    //!
+    //! When the SDM authenticates, the application that will be debugged has already been loaded.
+    SDMConnectMode_Restart = 1,
+
+    //! @brief Attach to running application.
+    //!
+    //! The SDM should not reset the target.
+    SDMConnectMode_Attach = 2,
+};
+
+//! @brief Type for default device type enum parameter.
+typedef uint32_t SDMConnectMode;
+
+/*!
+ * @brief Flags passed to SDMOpen() by the debugger.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMOpenParameters::flags field. Flags are only valid if SDMOpenParameters::version is at least the
+ * version that introduced the flag; undefined bits must be zero.
+ */
+enum SDMOpenFlagsEnum {
+    //! @brief The host implements the asynchronous I/O callbacks. Added in v1.1.
+    //!
+    //! If set, the SDM may use #SDMCallbacks::readMemoryAsync and the other callbacks in the asynchronous
+    //! I/O group. If not set, the SDM must only use the blocking callbacks.
+    SDMOpenFlags_AsyncIO = (1 << 0),
+
+    //! @brief The host's callbacks are reentrant. Added in v1.1.
+    //!
+    //! If set, the SDM may invoke callbacks for this handle from any thread, including threads it owns, and may
+    //! invoke them concurrently, as long as an API call for the handle is in progress. The exception is
+    //! #SDMCallbacks::presentForm, which must still be invoked only from the thread that called the API. If not
+    //! set, callbacks must only be invoked from the thread that called the API.
+    SDMOpenFlags_ReentrantCallbacks = (1 << 1),
+};
+
+/*!
+ * @brief Host capability flags.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMHostCapabilities::flags field.
+ */
+enum SDMHostCapabilityFlagsEnum {
+    //! @brief Register poll loops are performed by the debug probe.
+    //!
+    //! Each poll read does not require a round trip between the host and the probe.
+    SDMHostCapability_ProbePolling = (1 << 0),
+
+    //! @brief The reset callbacks return before the reset completes.
+    //!
+    //! #SDMCallbacks::resetStart does not wait for the target, and #SDMCallbacks::resetFinish waits for the
+    //! remainder of the reset sequence, so work done between them overlaps the reset.
+    SDMHostCapability_OverlappedReset = (1 << 1),
+
+    //! @brief The host caches reads of memory regions declared immutable.
+    //!
+    //! See #SDMCallbacks::declareMemoryRegion. Without this flag the SDM may still declare regions, but should
+    //! not rely on repeated reads being cheap.
+    SDMHostCapability_ReadCache = (1 << 2),
+
+    //! @brief The host coalesces the accesses of a transaction group into fewer probe commands.
+    //!
+    //! See #SDMCallbacks::beginTransactionGroup. Without this flag the SDM may still use transaction groups, but
+    //! should not expect them to be faster than individual calls.
+    SDMHostCapability_TransactionGroups = (1 << 3),
+};
+
+/*!
+ * @brief Capabilities of the host and its debug probe.
+ *
+ * Passed to the SDM through SDMOpenParameters::hostCapabilities. Added in v1.1.
+ */
+typedef struct SDMHostCapabilities {
+    //! @brief Mask composed of #SDMHostCapabilityFlagsEnum enums.
+    uint32_t flags;
+
+    //! @brief Smallest non-zero poll interval in microseconds that the host or probe honours.
+    //!
+    //! Shorter intervals requested with SDMRegisterAccessEx::pollIntervalUs are rounded up. Zero if unknown.
+    uint32_t minPollIntervalUs;
+
+    //! @brief Register transfer sizes supported by #SDMCallbacks::registerAccessEx.
+    //!
+    //! Mask composed of #SDMTransferSizeMaskEnum enums. Zero means that only #SDMTransferSize_32 is supported.
+    uint32_t registerTransferSizes;
+
+    //! @brief Minimum alignment in bytes of buffers returned by #SDMCallbacks::acquireTransferBuffer.
+    //!
+    //! A power of two. Zero if the host does not provide transfer buffers.
+    uint32_t transferBufferAlignment;
+
+    //! @brief Largest buffer size in bytes that #SDMCallbacks::acquireTransferBuffer can provide.
+    //!
+    //! Zero if the host does not provide transfer buffers.
+    size_t maxTransferBufferSize;
+
+    //! @brief Chunk size in bytes for #SDMCallbacks::writeStreamChunk that makes best use of the link.
+    //!
+    //! Zero if the host does not provide write streams or has no preference.
+    size_t preferredWriteChunkSize;
+
+    //! @brief Number of chunks the host queues per write stream before #SDMCallbacks::writeStreamChunk waits.
+    //!
+    //! Zero if the host does not provide write streams.
+    uint32_t writeStreamQueueDepth;
+} SDMHostCapabilities;
+
+/*!
+ * @brief Identification of a discovered device.
+ *
+ * One entry of #SDMTopology. For Arm ADI targets, an entry describes either an AP (#SDMDeviceType_ArmADI_AP) or a
+ * CoreSight component (#SDMDeviceType_ArmADI_CoreSightComponent), with the ID register values read by the host.
+ * Added in v1.1.
+ */
+typedef struct SDMComponentInfo {
+    //! @brief Descriptor for the device.
+    //!
+    //! The _memAp_ member of a CoreSight component must point to the _device_ member of another entry of the same
+    //! topology, or be NULL for a component within the DP address space.
+    SDMDeviceDescriptor device;
+
+    uint32_t cidr;      //!< Component ID, CIDR3 to CIDR0 combined with CIDR0 in the low byte. Zero if unknown.
+    uint32_t devarch;   //!< DEVARCH register value. Zero if not implemented or unknown.
+    uint64_t pidr;      //!< Peripheral ID, PIDR7 to PIDR0 combined with PIDR0 in the low byte. Zero if unknown.
+    uint32_t devtype;   //!< DEVTYPE register value. Zero if not implemented or unknown.
+    uint32_t apIdr;     //!< For APs, the IDR register value. Zero for other devices or if unknown.
+} SDMComponentInfo;
+
+/*!
+ * @brief Topology flags.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMTopology::flags field.
+ */
+enum SDMTopologyFlagsEnum {
+    //! @brief The topology lists every AP, and every component reachable through the ROM tables.
+    //!
+    //! Without this flag, the SDM must perform its own discovery for devices it does not find in the topology.
+    SDMTopology_Complete = (1 << 0),
+};
+
+/*!
+ * @brief Target topology discovered by the host.
+ *
+ * Passed to the SDM through SDMOpenParameters::topology, so that the SDM can find its mailbox and other
+ * devices without walking the DP, AP, and ROM tables again. Added in v1.1.
+ *
+ * The SDM may rely on the topology as given. It should still confirm the ID registers of a device it is going
+ * to use, which costs one read instead of a walk. The topology must remain valid until SDMClose(), and must
+ * still describe the target after SDMReattach(); if the host discovers a different topology, it must close and
+ * reopen the SDM instance.
+ */
+typedef struct SDMTopology {
+    uint32_t flags;                         //!< Mask composed of #SDMTopologyFlagsEnum enums.
+    const SDMComponentInfo *components;     //!< Array of discovered devices.
+    size_t componentCount;                  //!< Number of entries in the _components_ array.
+} SDMTopology;
+
+/*!
+ * @brief Pre-supplied value for a form element.
+ *
+ * Passed to the SDM through SDMOpenParameters::formAnswers, for headless and automated use. Added in v1.1.
+ *
+ * Values are UTF-8 encoded text. The encoding depends on the element type:
+ *
+ * - #SDMForm_TextField and #SDMForm_PathSelect: the text or path.
+ * - #SDMForm_Checkbox: "active", "inactive", or "mixed", for the #SDMControlStateEnum values.
+ * - #SDMForm_ItemSelect: the decimal index of the selected item, or "-1" for no selection.
+ *
+ * An answer that cannot be decoded for its element, or does not fit the element's buffer, causes the operation
+ * that presents the form to fail with #SDMReturnCode_InvalidArgument.
+ */
+typedef struct SDMFormAnswer {
+    const char *formId;     //!< SDMForm::id of the form. If NULL, the answer applies to the element in any form.
+    const char *elementId;  //!< SDMFormElement::id of the element. Must not be NULL.
+    const char *value;      //!< Value for the element. Must not be NULL.
+} SDMFormAnswer;
+
+/*!
+ * @brief Parameters passed to SDMOpen() by the debugger.
+ */
+typedef struct SDMOpenParameters {
+    struct {
+        uint16_t major; /*!< Client interface major version. */
+        uint16_t minor; /*!< Client interface minor version. */
+    } version; /*!< Client interface version. @see #SDMVersionEnum. */
+    SDMDebugArchitecture debugArchitecture; /*!< Debug architecture for the target. */
+    SDMCallbacks *callbacks; /*!< Callback collection */
+    void *refcon; /*!< Debugger-supplied value passed to each of the callbacks. */
+    const char *resourcesDirectoryPath; /*!< Absolute path to the directory containing the SDM plugin's resources. */
+    const char *manifestFilePath; /*!< Absolute path to the manifest XML file. Lazy libraries listed in the manifest are located relative to this path. */
+    uint32_t flags; /*!< Flags passed to the SDM from the debugger. Mask composed of #SDMOpenFlagsEnum enums. */
+    const char **locales; /*!< Pointer to a NULL-terminated array of IETF BCP 47 language tags, e.g. "en-US", "fr-FR", "sv", etc. The  tags are sorted in decreasing priority order. */
+    SDMConnectMode connectMode; /*!< Debugger connect mode. */
+    const SDMHostCapabilities *hostCapabilities; /*!< Capabilities of the host and probe. May be NULL if none are known. Added in v1.1. */
+    const SDMFormAnswer *formAnswers; /*!< Pre-supplied form element values. An answer with a form ID takes precedence over one without. May be NULL. Must remain valid until SDMClose(). Added in v1.1. */
+    size_t formAnswerCount; /*!< Number of entries in the _formAnswers_ array. Added in v1.1. */
+    const SDMTopology *topology; /*!< Target topology discovered by the host. May be NULL if the host has not performed discovery. Added in v1.1. */
+} SDMOpenParameters;
+
+/*!
+ * @brief Flags passed by the debugger to the SDMAuthenticate() API.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMAuthenticateParameters::flags field.
+ *
+ * The authentication cache flags only have an effect if the "authentication-cache" feature is enabled in the
+ * SDM XML. The cache is maintained by the SDM and is shared by all SDM instances within a process, so that it
+ * outlives the SDMClose() and SDMOpen() calls of a debugger reconnect. The feature's value, if present, is the
+ * maximum lifetime in seconds of a cache entry.
+ *
+ * Cache entries are keyed on the target's identity as read from the target during authentication (for
+ * instance, the SoC ID), the target's challenge nonce policy, and SDMOpenParameters::connectMode. An entry
+ * holds whatever the protocol allows to be reused, such as loaded credentials, or the fact that the target is
+ * still unlocked. Before using an entry, the SDM must confirm with the target that its lifecycle state and
+ * current debug permissions still allow it. If they do not, the entry is discarded and a full authentication
+ * is performed.
+ */
+enum SDMAuthenticateFlagsEnum {
+    //! @brief The SDM may satisfy the authentication from the authentication cache. Added in v1.1.
+    //!
+    //! If not set, a full authentication is always performed, although its result may still be added to the
+    //! cache.
+    SDMAuthenticateFlags_AllowCachedAuthentication = (1 << 0),
+
+    //! @brief The result of the authentication must not be added to the authentication cache. Added in v1.1.
+    SDMAuthenticateFlags_NoCacheUpdate = (1 << 1),
+
+    //! @brief Reset the target at the start of the authentication, and prepare while it is in reset. Added in v1.1.
+    //!
+    //! The SDM calls #SDMCallbacks::resetStart with #SDMResetType_Default, then performs the preparation that
+    //! does not need the target, such as decoding credentials, precomputing signature values where the protocol
+    //! allows it, and building mailbox transfer buffers. It then calls #SDMCallbacks::resetFinish and
+    //! continues with the authentication. The preparation only overlaps the reset if the host sets
+    //! #SDMHostCapability_OverlappedReset.
+    //!
+    //! Only has an effect if the "prepare-during-reset" feature is enabled in the SDM XML; otherwise ignored.
+    SDMAuthenticateFlags_PrepareDuringReset = (1 << 2),
+};
+
+/*!
+ * @brief Parameters passed by the debugger to the SDMAuthenticate() API.
+ */
+typedef struct SDMAuthenticateParameters {
+    SDMBool isLastAuthentication; //!< False if at least one subsequent call to SDMAuthenticate() is expected.
+    uint32_t flags; //!< Mask composed of #SDMAuthenticateFlagsEnum enums. Added in v1.1.
+} SDMAuthenticateParameters;
+
+/*!
+ * @brief Identifiers for #SDMCallbacks members.
+ *
+ * Used as array indices in #SDMStatistics. Added in v1.1.
+ */
+enum SDMCallbackIdEnum {
+    SDMCallbackId_UpdateProgress = 0,       //!< #SDMCallbacks::updateProgress
+    SDMCallbackId_SetErrorMessage = 1,      //!< #SDMCallbacks::setErrorMessage
+    SDMCallbackId_ResetStart = 2,           //!< #SDMCallbacks::resetStart
+    SDMCallbackId_ResetFinish = 3,          //!< #SDMCallbacks::resetFinish
+    SDMCallbackId_ReadMemory = 4,           //!< #SDMCallbacks::readMemory
+    SDMCallbackId_WriteMemory = 5,          //!< #SDMCallbacks::writeMemory
+    SDMCallbackId_RegisterAccess = 6,       //!< #SDMCallbacks::registerAccess
+    SDMCallbackId_PresentForm = 7,          //!< #SDMCallbacks::presentForm
+    SDMCallbackId_TransferMemoryBatch = 8,  //!< #SDMCallbacks::transferMemoryBatch
+    SDMCallbackId_ReadMemoryAsync = 9,      //!< #SDMCallbacks::readMemoryAsync
+    SDMCallbackId_WriteMemoryAsync = 10,    //!< #SDMCallbacks::writeMemoryAsync
+    SDMCallbackId_RegisterAccessAsync = 11, //!< #SDMCallbacks::registerAccessAsync
+    SDMCallbackId_CancelAsyncRequest = 12,  //!< #SDMCallbacks::cancelAsyncRequest
+    SDMCallbackId_RegisterAccessEx = 13,    //!< #SDMCallbacks::registerAccessEx
+    SDMCallbackId_AcquireTransferBuffer = 14, //!< #SDMCallbacks::acquireTransferBuffer
+    SDMCallbackId_ReleaseTransferBuffer = 15, //!< #SDMCallbacks::releaseTransferBuffer
+    SDMCallbackId_LoadFormValue = 16,       //!< #SDMCallbacks::loadFormValue
+    SDMCallbackId_StoreFormValue = 17,      //!< #SDMCallbacks::storeFormValue
+    SDMCallbackId_ReportProgressEvent = 18, //!< #SDMCallbacks::reportProgressEvent
+    SDMCallbackId_DeclareMemoryRegion = 19, //!< #SDMCallbacks::declareMemoryRegion
+    SDMCallbackId_InvalidateMemoryCache = 20, //!< #SDMCallbacks::invalidateMemoryCache
+    SDMCallbackId_OpenWriteStream = 21,     //!< #SDMCallbacks::openWriteStream
+    SDMCallbackId_WriteStreamChunk = 22,    //!< #SDMCallbacks::writeStreamChunk
+    SDMCallbackId_CloseWriteStream = 23,    //!< #SDMCallbacks::closeWriteStream
+    SDMCallbackId_BeginTransactionGroup = 24, //!< #SDMCallbacks::beginTransactionGroup
+    SDMCallbackId_CommitTransactionGroup = 25, //!< #SDMCallbacks::commitTransactionGroup
+};
+
+//! @brief Type for callback identifier.
+typedef uint32_t SDMCallbackId;
+
+/*!
+ * @brief Array sizes used in #SDMStatistics.
+ *
+ * The array sizes are fixed so the structure layout does not change when new phases or callbacks are defined.
+ */
+enum SDMStatisticsLimitsEnum {
+    SDMStatistics_MaxPhases = 16,       //!< Number of entries in the per-phase arrays.
+    SDMStatistics_MaxCallbacks = 32,    //!< Number of entries in the per-callback arrays.
+    SDMStatistics_TransferSizes = 4,    //!< Number of entries in the per-transfer size arrays.
+};
+
+/*!
+ * @brief Performance counters for an SDM instance.
+ *
+ * Filled in by SDMGetStatistics(). All counters are cumulative from SDMOpen(), or from the last call to
+ * SDMGetStatistics() that requested a reset. Times are wall-clock times in nanoseconds, measured by the SDM
+ * with a monotonic clock. Counters that the SDM does not implement are set to zero.
+ *
+ * Per-transfer size arrays are indexed by transfer size, in the order #SDMTransferSize_8, #SDMTransferSize_16,
+ * #SDMTransferSize_32, #SDMTransferSize_64. Register accesses are included in the byte counts.
+ */
+typedef struct SDMStatistics {
+    //! [in] Must be set by the caller to sizeof(SDMStatistics). Members beyond this size are not written.
+    uint32_t structSize;
+
+    //! Reserved for future use. Set to zero.
+    uint32_t reserved;
+
+    //! Number of authentications performed, including failed authentications.
+    uint64_t authenticationCount;
+
+    //! Total time spent within SDM API calls, including time spent in callbacks.
+    uint64_t totalTimeNs;
+
+    //! Time spent in each authentication phase, indexed by #SDMPhaseEnum.
+    uint64_t phaseTimeNs[SDMStatistics_MaxPhases];
+
+    //! Number of invocations of each callback, indexed by #SDMCallbackIdEnum.
+    uint64_t callbackCount[SDMStatistics_MaxCallbacks];
+
+    //! Time spent waiting for each callback to return, indexed by #SDMCallbackIdEnum. For asynchronous
+    //! callbacks, this is the time from queuing the request to invocation of the completion routine.
+    uint64_t callbackTimeNs[SDMStatistics_MaxCallbacks];
+
+    //! Bytes read from the target, per transfer size.
+    uint64_t bytesRead[SDMStatistics_TransferSizes];
+
+    //! Bytes written to the target, per transfer size.
+    uint64_t bytesWritten[SDMStatistics_TransferSizes];
+
+    //! Number of #SDMRegisterAccessOp_Poll operations requested.
+    uint64_t pollCount;
+
+    //! Number of times the SDM reissued a poll because a previous poll did not match before its retry limit.
+    uint64_t pollRetries;
+} SDMStatistics;
+
+/*!
+ * @brief Session capability flags.
+ *
+ * These enumerators are bit masks that are intended to be bitwise-or'd together to be used in the
+ * SDMCapabilities::flags field. Added in v1.1.
+ *
+ * The low 16 bits describe SDM API features available on the handle. The high 16 bits describe the optional
+ * host callbacks that the SDM will use for the session, given the callbacks the host provides, its
+ * #SDMHostCapabilities, and the connected target.
+ */
+enum SDMCapabilityFlagsEnum {
+    SDMCapability_ResumeBoot = (1 << 0),                //!< SDMResumeBoot() is usable.
+    SDMCapability_MultipleAuthentications = (1 << 1),   //!< SDMAuthenticate() may be called more than once.
+    SDMCapability_ResumableAuthentication = (1 << 2),   //!< SDMAuthenticateStart() and the related functions are usable.
+    SDMCapability_AuthenticationCache = (1 << 3),       //!< #SDMAuthenticateFlags_AllowCachedAuthentication is honoured.
+    SDMCapability_MultiDeviceAuthentication = (1 << 4), //!< SDMAuthenticateDevices() is usable.
+    SDMCapability_Reattach = (1 << 5),                  //!< SDMReattach() is usable.
+    SDMCapability_PrepareDuringReset = (1 << 6),        //!< #SDMAuthenticateFlags_PrepareDuringReset is honoured.
+    SDMCapability_ThreadSafeHandle = (1 << 7),          //!< The handle may be used from several threads.
+    SDMCapability_Statistics = (1 << 8),                //!< SDMGetStatistics() is usable.
+
+    SDMCapability_UsesTransferMemoryBatch = (1 << 16),  //!< The SDM uses #SDMCallbacks::transferMemoryBatch.
+    SDMCapability_UsesAsyncIO = (1 << 17),              //!< The SDM uses the asynchronous I/O callbacks.
+    SDMCapability_UsesRegisterAccessEx = (1 << 18),     //!< The SDM uses #SDMCallbacks::registerAccessEx.
+    SDMCapability_UsesTransferBuffers = (1 << 19),      //!< The SDM uses host-allocated transfer buffers.
+    SDMCapability_UsesWriteStreams = (1 << 20),         //!< The SDM uses the write stream callbacks.
+    SDMCapability_UsesTransactionGroups = (1 << 21),    //!< The SDM uses the transaction group callbacks.
+    SDMCapability_UsesMemoryRegions = (1 << 22),        //!< The SDM declares memory regions for the read cache.
+    SDMCapability_UsesProgressEvents = (1 << 23),       //!< The SDM reports progress events.
+    SDMCapability_UsesFormValueCache = (1 << 24),       //!< The SDM uses the form value cache callbacks.
+};
+
+/*!
+ * @brief Capabilities and limits of an SDM session.
+ *
+ * Filled in by SDMQueryCapabilities(). A limit of zero means that the SDM imposes no limit, or has no
+ * preference. Added in v1.1.
+ */
+typedef struct SDMCapabilities {
+    //! [in] Must be set by the caller to sizeof(SDMCapabilities). Members beyond this size are not written.
+    uint32_t structSize;
+
+    //! Mask composed of #SDMCapabilityFlagsEnum enums.
+    uint32_t flags;
+
+    //! Maximum number of devices per SDMAuthenticateDevices() call.
+    uint32_t maxDevicesPerAuthentication;
+
+    //! Maximum lifetime in seconds of a cached authentication.
+    uint32_t authenticationCacheLifetimeS;
+
+    //! Maximum number of accesses the SDM passes in one register access callback.
+    uint32_t maxRegisterAccessesPerCall;
+
+    //! Maximum number of accesses the SDM passes in one #SDMCallbacks::transferMemoryBatch call.
+    uint32_t maxMemoryBatchSize;
+
+    //! Maximum number of asynchronous requests the SDM keeps in flight.
+    uint32_t maxAsyncRequestsInFlight;
+
+    //! Maximum number of write stream chunks the SDM keeps queued per stream.
+    uint32_t maxWriteStreamChunksInFlight;
+
+    //! Size in bytes of the largest memory transfer or write stream chunk the SDM issues.
+    uint64_t maxTransferSize;
+} SDMCapabilities;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @name API
+//@{
+/*!
+ * @brief This function is called by the debugger to start a secure debug session with the remote platform.
+ *
+ * Libraries listed in the manifest with a `load` value of "lazy" have not been loaded by the host when this API
+ * is called. The SDM should defer loading them until they are first needed, so that flows which do not use
+ * them, such as an #SDMConnectMode_Attach connection to an already unlocked target, do not pay their load time.
+ *
+ * @param[out] handle New handle to the SDM instance.
+ * @param[in] params Connection details and callbacks. This pointer and all nested pointers will remain valid
+ *  until SDMClose() is called, so the plugin can cache the value for later use without having to copy all
+ *  the data.
+ *
+ * @retval SDMReturnCode_Success SDM plugin initialized successfully.
+ * @retval SDMReturnCode_RequestFailed
+ */
 SDM_EXTERN SDMReturnCode SDMOpen(SDMHandle *handle, const SDMOpenParameters *params);
 
 /*!
@@ -830,6 +2064,128 @@ SDM_EXTERN SDMReturnCode SDMOpen(SDMHandle *handle, const SDMOpenParameters *par
  */
 SDM_EXTERN SDMReturnCode SDMAuthenticate(SDMHandle handle, const SDMAuthenticateParameters *params);
 
+/*!
+ * @brief Perform authentication for several devices of the target.
+ *
+ * Authenticates each of the listed devices, for instance the debug mailbox of each die in a multi-die system,
+ * as if SDMAuthenticate() were called once per device. The SDM may overlap the protocol exchanges for different
+ * devices, for instance by batching their register accesses or by keeping asynchronous requests for several
+ * devices outstanding, so the total time is less than that of sequential authentications. Forms and progress
+ * updates may be shared across devices.
+ *
+ * This is an optional entry point, added in v1.1, that is only exported if the "multi-device-authentication"
+ * feature is enabled in the SDM XML. The feature's value, if present, is the maximum _deviceCount_ supported.
+ *
+ * @param[in] handle Handle to the SDM instance.
+ * @param[in] params Parameters for the authentication, which apply to all devices. The pointer only needs to be
+ *      valid during the call to this API.
+ * @param[in] devices Array of descriptors for the devices to authenticate. The descriptors must be of a type
+ *      the SDM accepts for the debug architecture, such as #SDMDeviceType_ArmADI_AP. Only needs to be valid during
+ *      the call to this API.
+ * @param[in] deviceCount Number of elements in the _devices_ and _results_ arrays.
+ * @param[out] results Array that receives the result of the authentication of each device, with the same values
+ *      as SDMAuthenticate().
+ *
+ * @retval SDMReturnCode_Success Authentication succeeded for all devices.
+ * @retval SDMReturnCode_RequestFailed Authentication failed for at least one device; see _results_.
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_UserCancelled No device was authenticated. All _results_ are set to this value.
+ */
+SDM_EXTERN SDMReturnCode SDMAuthenticateDevices(
+    SDMHandle handle,
+    const SDMAuthenticateParameters *params,
+    const SDMDeviceDescriptor *devices,
+    size_t deviceCount,
+    SDMReturnCode *results);
+
+/*!
+ * @brief Begin a resumable authentication.
+ *
+ * SDMAuthenticateStart(), SDMAuthenticateStep(), and SDMAuthenticateCancel() together are an alternative to
+ * SDMAuthenticate() that lets the host drive the authentication one protocol phase at a time. They are optional
+ * entry points, added in v1.1, that are only exported if the "resumable-authentication" feature is enabled in
+ * the SDM XML. Hosts must look them up dynamically and fall back to SDMAuthenticate() if they are not present.
+ *
+ * A resumable authentication has the same semantics and results as a call to SDMAuthenticate() with the same
+ * parameters. Each call performs at most one protocol phase, for instance sending a challenge request or
+ * transferring a certificate, then returns. The #SDMReturnCode_WouldBlock return code indicates that the
+ * authentication is still in progress and the host must call SDMAuthenticateStep() to continue it. Any other
+ * return code ends the authentication, with the same meaning as for SDMAuthenticate().
+ *
+ * If #SDMOpenFlags_AsyncIO was set in SDMOpenParameters::flags, the SDM queues the I/O for the phase with the
+ * asynchronous callbacks and returns #SDMReturnCode_WouldBlock without waiting for it to complete. The host
+ * should then not call SDMAuthenticateStep() until a completion routine for one of the SDM's requests has been
+ * invoked. Otherwise, the I/O for each phase is performed with the blocking callbacks before returning, and the
+ * host may call SDMAuthenticateStep() again immediately.
+ *
+ * While a resumable authentication is in progress, the host must not call any SDM API for the same handle other
+ * than SDMAuthenticateStep() and SDMAuthenticateCancel().
+ *
+ * @param[in] handle Handle to the SDM instance.
+ * @param[in] params Parameters for the authentication. The pointer only needs to be valid during
+ *      the call to this API.
+ *
+ * @retval SDMReturnCode_WouldBlock Authentication is in progress; call SDMAuthenticateStep() to continue.
+ * @retval SDMReturnCode_Success Authentication succeeded.
+ * @retval SDMReturnCode_RequestFailed
+ * @retval SDMReturnCode_InvalidUserCredentials
+ * @retval SDMReturnCode_UserCancelled
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_TimeoutError
+ */
+SDM_EXTERN SDMReturnCode SDMAuthenticateStart(SDMHandle handle, const SDMAuthenticateParameters *params);
+
+/*!
+ * @brief Continue a resumable authentication.
+ *
+ * Performs the next protocol phase of an authentication begun with SDMAuthenticateStart(). The
+ * #SDMCallbacks::presentForm callback may be invoked from within this API, the same as for SDMAuthenticate().
+ *
+ * @param[in] handle Handle to the SDM instance.
+ *
+ * @retval SDMReturnCode_WouldBlock Authentication is in progress; call SDMAuthenticateStep() to continue.
+ * @retval SDMReturnCode_Success Authentication succeeded.
+ * @retval SDMReturnCode_InvalidArgument No resumable authentication is in progress.
+ * @retval SDMReturnCode_RequestFailed
+ * @retval SDMReturnCode_InvalidUserCredentials
+ * @retval SDMReturnCode_UserCancelled
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_TimeoutError
+ */
+SDM_EXTERN SDMReturnCode SDMAuthenticateStep(SDMHandle handle);
+
+/*!
+ * @brief Abandon a resumable authentication.
+ *
+ * Ends an authentication begun with SDMAuthenticateStart(). Any outstanding asynchronous requests are cancelled,
+ * and their completion routines will have been invoked before this API returns. The target may be left in a
+ * locked state. A new authentication may be started afterwards.
+ *
+ * Calling this API when no resumable authentication is in progress has no effect.
+ *
+ * @param[in] handle Handle to the SDM instance.
+ *
+ * @retval SDMReturnCode_Success The authentication was ended.
+ */
+SDM_EXTERN SDMReturnCode SDMAuthenticateCancel(SDMHandle handle);
+
+/*!
+ * @brief Discard authentication cache entries for the target.
+ *
+ * Removes all authentication cache entries matching the target connected through this SDM instance, so the
+ * next authentication is a full authentication. A debugger should call this API when it knows that cached
+ * state is stale, for instance after the target has been reprogrammed.
+ *
+ * This is an optional entry point, added in v1.1, that is only exported if the "authentication-cache" feature is
+ * enabled in the SDM XML.
+ *
+ * @param[in] handle Handle to the SDM instance.
+ *
+ * @retval SDMReturnCode_Success The matching cache entries, if any, were discarded.
+ * @retval SDMReturnCode_UnsupportedOperation
+ */
+SDM_EXTERN SDMReturnCode SDMInvalidateAuthenticationCache(SDMHandle handle);
+
 /*!
  * @brief Called by the debugger to resume the boot of the remote platform.
  *
@@ -850,6 +2206,76 @@ SDM_EXTERN SDMReturnCode SDMAuthenticate(SDMHandle handle, const SDMAuthenticate
  */
 SDM_EXTERN SDMReturnCode SDMResumeBoot(SDMHandle handle);
 
+/*!
+ * @brief Reconnect an SDM instance to the target.
+ *
+ * Used by the debugger in place of SDMClose() followed by SDMOpen() when the connection to the same target is
+ * re-established, for instance after a power cycle. The SDM keeps the state that does not depend on the
+ * target: the parsed manifest, loaded resources and credentials, and the SDMOpenParameters passed to SDMOpen(),
+ * including the callbacks and _refcon_. It discards all state learned from the target, such as discovered
+ * devices, mailbox link state, and the result of any previous authentication, and then performs the
+ * target-facing part of SDMOpen() again. After this API returns successfully, the instance is in the same state
+ * as after SDMOpen() with SDMOpenParameters::connectMode set to _connectMode_.
+ *
+ * The debugger may call #SDMCallbacks::resetStart and #SDMCallbacks::resetFinish, or power cycle the target,
+ * before calling this API. It must not be called during another API call for the same handle, including while
+ * an authentication started with SDMAuthenticateStart() is in progress. Authentication cache entries are not
+ * affected; they are revalidated with the target as usual. The host discards its memory read cache, if any,
+ * before calling this API.
+ *
+ * This is an optional entry point, added in v1.1, that is only exported if the "reattach" feature is enabled in
+ * the SDM XML. If it fails, the handle remains valid only for SDMClose().
+ *
+ * @param[in] handle Handle to the SDM instance.
+ * @param[in] connectMode Debugger connect mode for the new connection.
+ *
+ * @retval SDMReturnCode_Success The instance is ready for SDMAuthenticate().
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_IOError
+ * @retval SDMReturnCode_RequestFailed
+ */
+SDM_EXTERN SDMReturnCode SDMReattach(SDMHandle handle, SDMConnectMode connectMode);
+
+/*!
+ * @brief Read the performance counters of an SDM instance.
+ *
+ * This is an optional entry point, added in v1.1, that is only exported if the "statistics" feature is
+ * enabled in the SDM XML. It may be called at any time between SDMOpen() and SDMClose(), except during
+ * another API call for the same handle.
+ *
+ * Counting must add little overhead to the SDM, so an SDM may always collect statistics.
+ *
+ * @param[in] handle Handle to the SDM instance.
+ * @param[in,out] statistics Structure filled in with the counters. Its _structSize_ member must be set.
+ * @param[in] reset If true, all counters are reset to zero after being read.
+ *
+ * @retval SDMReturnCode_Success The counters were read.
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_UnsupportedOperation
+ */
+SDM_EXTERN SDMReturnCode SDMGetStatistics(SDMHandle handle, SDMStatistics *statistics, SDMBool reset);
+
+/*!
+ * @brief Query the capabilities of an SDM session.
+ *
+ * Unlike manifest features, the result reflects the session: the callbacks and #SDMHostCapabilities the host
+ * passed to SDMOpen(), and what the SDM has learned about the connected target. The host can use it, for
+ * instance, to set up its asynchronous I/O or write stream queues only for sessions that use them, and to size
+ * them from the reported limits.
+ *
+ * This is an optional entry point, added in v1.1, that is only exported if the "capabilities-query" feature is
+ * enabled in the SDM XML. It may be called at any time between SDMOpen() and SDMClose(), except during
+ * another API call for the same handle. The result may change after SDMAuthenticate() or SDMReattach(), since
+ * the SDM may learn more about the target.
+ *
+ * @param[in] handle Handle to the SDM instance.
+ * @param[in,out] capabilities Structure filled in with the capabilities. Its _structSize_ member must be set.
+ *
+ * @retval SDMReturnCode_Success The capabilities were read.
+ * @retval SDMReturnCode_InvalidArgument
+ */
+SDM_EXTERN SDMReturnCode SDMQueryCapabilities(SDMHandle handle, SDMCapabilities *capabilities);
+
 /*!
  * @brief Close the SDM session.
  *
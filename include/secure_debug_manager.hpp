@@ -0,0 +1,722 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @addtogroup sdm_cpp C++ Host Adapter
+ * @brief Optional header-only C++ layer over the SDM callbacks.
+ *
+ * This layer has two parts:
+ *
+ * - #SDMHost, a base class template for hosts. A host class derives from `SDMHost<Host>` and defines member
+ *   functions with the names and parameters of the #SDMCallbacks members, without the _refcon_ parameter.
+ *   SDMHost::callbacks() returns a conforming #SDMCallbacks table of static trampolines that call the host's
+ *   member functions directly. Optional callbacks the host does not define are NULL in the table.
+ * - Two dispatchers with the same member functions: #SDMTableDispatch, which calls through an #SDMCallbacks
+ *   table as any SDM must, and #SDMDirectDispatch, which calls a host class directly. An SDM written in C++ as a
+ *   template over its dispatcher can be built both as a shared library, with #SDMTableDispatch, and linked
+ *   statically into a simulation or test host, with `SDMDirectDispatch<Host>`. In the second case the compiler
+ *   sees the host's functions, and can inline hot paths such as register poll loops.
+ *
+ * The layer requires C++11 and does not change the C API or ABI.
+ *
+ * @code
+ * class SimHost : public SDMHost<SimHost> {
+ * public:
+ *     SDMReturnCode registerAccess(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+ *         const SDMRegisterAccess *accesses, size_t accessCount, size_t *accessesCompleted);
+ *     // ...
+ * };
+ *
+ * SimHost host;
+ * SDMOpenParameters params = {};
+ * host.fillOpenParameters(params);
+ * @endcode
+ *
+ * @{
+ */
+
+ /*!
+ * @file
+ *
+ * @brief This header file defines the optional C++ host adapter and callback dispatchers.
+ */
+
+#ifndef _SECURE_DEBUG_MANAGER_HPP_
+#define _SECURE_DEBUG_MANAGER_HPP_
+
+#include <type_traits>
+
+#include "secure_debug_manager.h"
+
+template <class Host>
+class SDMHost;
+
+//! @cond
+// True if Host defines its own member function named _name_ instead of inheriting the SDMHost default.
+#define _SDM_HOST_DEFINES(Host, name) \
+    (!std::is_same<decltype(&Host::name), decltype(&SDMHost<Host>::name)>::value)
+
+// Fail to compile if Host defines only one of two callbacks that must be provided together.
+#define _SDM_HOST_CHECK_PAIR(Host, first, second) \
+    static_assert(_SDM_HOST_DEFINES(Host, first) == _SDM_HOST_DEFINES(Host, second), \
+        "SDMHost: " #first " and " #second " must be defined together")
+
+// Check every callback set whose members are only valid together.
+#define _SDM_HOST_CHECK_PAIRS(Host) \
+    _SDM_HOST_CHECK_PAIR(Host, acquireTransferBuffer, releaseTransferBuffer); \
+    _SDM_HOST_CHECK_PAIR(Host, loadFormValue, storeFormValue); \
+    _SDM_HOST_CHECK_PAIR(Host, declareMemoryRegion, invalidateMemoryCache); \
+    _SDM_HOST_CHECK_PAIR(Host, openWriteStream, writeStreamChunk); \
+    _SDM_HOST_CHECK_PAIR(Host, openWriteStream, closeWriteStream); \
+    _SDM_HOST_CHECK_PAIR(Host, beginTransactionGroup, commitTransactionGroup)
+//! @endcond
+
+/*!
+ * @brief Base class template for hosts.
+ *
+ * The mandatory v1.0 callbacks have default implementations that fail, so that a partial host for tests still
+ * builds. The optional v1.1 callbacks have default implementations only so that the adapter can detect which
+ * ones the host defines; they are never called. Callbacks that are only valid together, such as
+ * beginTransactionGroup() and commitTransactionGroup(), must be defined together; otherwise the adapter fails to
+ * compile.
+ *
+ * @tparam Host The derived host class.
+ */
+template <class Host>
+class SDMHost {
+public:
+    /*!
+     * @brief Get the callback table for this host class.
+     *
+     * The table is the same for all instances; the instance is passed as the _refcon_.
+     */
+    static SDMCallbacks *callbacks()
+    {
+        static SDMCallbacks table = makeCallbacks();
+        return &table;
+    }
+
+    //! @brief Get the _refcon_ value for this instance.
+    void *refcon() { return static_cast<Host *>(this); }
+
+    //! @brief Set the version, callbacks and _refcon_ fields of open parameters for this instance.
+    void fillOpenParameters(SDMOpenParameters &params)
+    {
+        params.version.major = SDMVersion_CurrentMajor;
+        params.version.minor = SDMVersion_CurrentMinor;
+        params.callbacks = callbacks();
+        params.refcon = refcon();
+    }
+
+    //! @name Default callback implementations
+    //@{
+    void updateProgress(const char *, uint8_t) {}
+    void setErrorMessage(const char *, const char *) {}
+    SDMReturnCode resetStart(SDMResetType) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode resetFinish(SDMResetType) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode readMemory(const SDMDeviceDescriptor *, uint64_t, SDMTransferSize, size_t, uint32_t, void *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode writeMemory(const SDMDeviceDescriptor *, uint64_t, SDMTransferSize, size_t, uint32_t, const void *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode registerAccess(const SDMDeviceDescriptor *, SDMTransferSize, const SDMRegisterAccess *, size_t, size_t *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode presentForm(const SDMForm *) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode transferMemoryBatch(const SDMMemoryAccess *, size_t, size_t *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode readMemoryAsync(const SDMDeviceDescriptor *, uint64_t, SDMTransferSize, size_t, uint32_t, void *,
+        SDMIOCompletion, void *, SDMRequestToken *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode writeMemoryAsync(const SDMDeviceDescriptor *, uint64_t, SDMTransferSize, size_t, uint32_t,
+        const void *, SDMIOCompletion, void *, SDMRequestToken *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode registerAccessAsync(const SDMDeviceDescriptor *, SDMTransferSize, const SDMRegisterAccess *, size_t,
+        SDMIOCompletion, void *, SDMRequestToken *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode cancelAsyncRequest(SDMRequestToken) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode registerAccessEx(const SDMDeviceDescriptor *, SDMTransferSize, const SDMRegisterAccessEx *, size_t,
+        size_t *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode acquireTransferBuffer(size_t, void **) { return SDMReturnCode_UnsupportedOperation; }
+    void releaseTransferBuffer(void *) {}
+    SDMReturnCode loadFormValue(const char *, const char *, char *, size_t) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode storeFormValue(const char *, const char *, const char *) { return SDMReturnCode_UnsupportedOperation; }
+    void reportProgressEvent(const SDMProgressEvent *) {}
+    SDMReturnCode declareMemoryRegion(const SDMDeviceDescriptor *, uint64_t, uint64_t, uint32_t, SDMMemoryRegionKind)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    void invalidateMemoryCache(const SDMDeviceDescriptor *, uint64_t, uint64_t) {}
+    SDMReturnCode openWriteStream(const SDMDeviceDescriptor *, uint64_t, SDMTransferSize, uint32_t, uint64_t,
+        SDMWriteStream *)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode writeStreamChunk(SDMWriteStream, const void *, size_t, uint32_t)
+    {
+        return SDMReturnCode_UnsupportedOperation;
+    }
+    SDMReturnCode closeWriteStream(SDMWriteStream, SDMBool, uint64_t *) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode beginTransactionGroup(uint32_t) { return SDMReturnCode_UnsupportedOperation; }
+    SDMReturnCode commitTransactionGroup(size_t *) { return SDMReturnCode_UnsupportedOperation; }
+    //@}
+
+protected:
+    SDMHost() {}
+    ~SDMHost() {}
+
+private:
+    static Host *self(void *refcon) { return static_cast<Host *>(refcon); }
+
+    //! @name Trampolines
+    //@{
+    static void updateProgressThunk(const char *progressMessage, uint8_t percentComplete, void *refcon)
+    {
+        self(refcon)->updateProgress(progressMessage, percentComplete);
+    }
+    static void setErrorMessageThunk(const char *errorMessage, const char *errorDetails, void *refcon)
+    {
+        self(refcon)->setErrorMessage(errorMessage, errorDetails);
+    }
+    static SDMReturnCode resetStartThunk(SDMResetType resetType, void *refcon)
+    {
+        return self(refcon)->resetStart(resetType);
+    }
+    static SDMReturnCode resetFinishThunk(SDMResetType resetType, void *refcon)
+    {
+        return self(refcon)->resetFinish(resetType);
+    }
+    static SDMReturnCode readMemoryThunk(const SDMDeviceDescriptor *device, uint64_t address,
+        SDMTransferSize transferSize, size_t transferCount, uint32_t attributes, void *data, void *refcon)
+    {
+        return self(refcon)->readMemory(device, address, transferSize, transferCount, attributes, data);
+    }
+    static SDMReturnCode writeMemoryThunk(const SDMDeviceDescriptor *device, uint64_t address,
+        SDMTransferSize transferSize, size_t transferCount, uint32_t attributes, const void *data, void *refcon)
+    {
+        return self(refcon)->writeMemory(device, address, transferSize, transferCount, attributes, data);
+    }
+    static SDMReturnCode registerAccessThunk(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, size_t *accessesCompleted, void *refcon)
+    {
+        return self(refcon)->registerAccess(device, transferSize, accesses, accessCount, accessesCompleted);
+    }
+    static SDMReturnCode presentFormThunk(const SDMForm *form, void *refcon)
+    {
+        return self(refcon)->presentForm(form);
+    }
+    static SDMReturnCode transferMemoryBatchThunk(const SDMMemoryAccess *accesses, size_t accessCount,
+        size_t *accessesCompleted, void *refcon)
+    {
+        return self(refcon)->transferMemoryBatch(accesses, accessCount, accessesCompleted);
+    }
+    static SDMReturnCode readMemoryAsyncThunk(const SDMDeviceDescriptor *device, uint64_t address,
+        SDMTransferSize transferSize, size_t transferCount, uint32_t attributes, void *data,
+        SDMIOCompletion completion, void *completionContext, SDMRequestToken *token, void *refcon)
+    {
+        return self(refcon)->readMemoryAsync(device, address, transferSize, transferCount, attributes, data,
+            completion, completionContext, token);
+    }
+    static SDMReturnCode writeMemoryAsyncThunk(const SDMDeviceDescriptor *device, uint64_t address,
+        SDMTransferSize transferSize, size_t transferCount, uint32_t attributes, const void *value,
+        SDMIOCompletion completion, void *completionContext, SDMRequestToken *token, void *refcon)
+    {
+        return self(refcon)->writeMemoryAsync(device, address, transferSize, transferCount, attributes, value,
+            completion, completionContext, token);
+    }
+    static SDMReturnCode registerAccessAsyncThunk(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, SDMIOCompletion completion, void *completionContext,
+        SDMRequestToken *token, void *refcon)
+    {
+        return self(refcon)->registerAccessAsync(device, transferSize, accesses, accessCount, completion,
+            completionContext, token);
+    }
+    static SDMReturnCode cancelAsyncRequestThunk(SDMRequestToken token, void *refcon)
+    {
+        return self(refcon)->cancelAsyncRequest(token);
+    }
+    static SDMReturnCode registerAccessExThunk(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccessEx *accesses, size_t accessCount, size_t *accessesCompleted, void *refcon)
+    {
+        return self(refcon)->registerAccessEx(device, transferSize, accesses, accessCount, accessesCompleted);
+    }
+    static SDMReturnCode acquireTransferBufferThunk(size_t size, void **buffer, void *refcon)
+    {
+        return self(refcon)->acquireTransferBuffer(size, buffer);
+    }
+    static void releaseTransferBufferThunk(void *buffer, void *refcon)
+    {
+        self(refcon)->releaseTransferBuffer(buffer);
+    }
+    static SDMReturnCode loadFormValueThunk(const char *formId, const char *elementId, char *buffer,
+        size_t bufferLength, void *refcon)
+    {
+        return self(refcon)->loadFormValue(formId, elementId, buffer, bufferLength);
+    }
+    static SDMReturnCode storeFormValueThunk(const char *formId, const char *elementId, const char *value,
+        void *refcon)
+    {
+        return self(refcon)->storeFormValue(formId, elementId, value);
+    }
+    static void reportProgressEventThunk(const SDMProgressEvent *event, void *refcon)
+    {
+        self(refcon)->reportProgressEvent(event);
+    }
+    static SDMReturnCode declareMemoryRegionThunk(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size,
+        uint32_t attributes, SDMMemoryRegionKind kind, void *refcon)
+    {
+        return self(refcon)->declareMemoryRegion(device, address, size, attributes, kind);
+    }
+    static void invalidateMemoryCacheThunk(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size,
+        void *refcon)
+    {
+        self(refcon)->invalidateMemoryCache(device, address, size);
+    }
+    static SDMReturnCode openWriteStreamThunk(const SDMDeviceDescriptor *device, uint64_t address,
+        SDMTransferSize transferSize, uint32_t attributes, uint64_t totalSize, SDMWriteStream *stream, void *refcon)
+    {
+        return self(refcon)->openWriteStream(device, address, transferSize, attributes, totalSize, stream);
+    }
+    static SDMReturnCode writeStreamChunkThunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags,
+        void *refcon)
+    {
+        return self(refcon)->writeStreamChunk(stream, data, size, flags);
+    }
+    static SDMReturnCode closeWriteStreamThunk(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten,
+        void *refcon)
+    {
+        return self(refcon)->closeWriteStream(stream, abort, bytesWritten);
+    }
+    static SDMReturnCode beginTransactionGroupThunk(uint32_t flags, void *refcon)
+    {
+        return self(refcon)->beginTransactionGroup(flags);
+    }
+    static SDMReturnCode commitTransactionGroupThunk(size_t *callsCompleted, void *refcon)
+    {
+        return self(refcon)->commitTransactionGroup(callsCompleted);
+    }
+    //@}
+
+    static SDMCallbacks makeCallbacks()
+    {
+        _SDM_HOST_CHECK_PAIRS(Host);
+        SDMCallbacks table = {};
+        table.updateProgress = updateProgressThunk;
+        table.setErrorMessage = setErrorMessageThunk;
+        table.resetStart = resetStartThunk;
+        table.resetFinish = resetFinishThunk;
+        table.readMemory = readMemoryThunk;
+        table.writeMemory = writeMemoryThunk;
+        table.registerAccess = registerAccessThunk;
+        table.presentForm = presentFormThunk;
+        if (_SDM_HOST_DEFINES(Host, transferMemoryBatch)) {
+            table.transferMemoryBatch = transferMemoryBatchThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, readMemoryAsync)) {
+            table.readMemoryAsync = readMemoryAsyncThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, writeMemoryAsync)) {
+            table.writeMemoryAsync = writeMemoryAsyncThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, registerAccessAsync)) {
+            table.registerAccessAsync = registerAccessAsyncThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, cancelAsyncRequest)) {
+            table.cancelAsyncRequest = cancelAsyncRequestThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, registerAccessEx)) {
+            table.registerAccessEx = registerAccessExThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, acquireTransferBuffer) && _SDM_HOST_DEFINES(Host, releaseTransferBuffer)) {
+            table.acquireTransferBuffer = acquireTransferBufferThunk;
+            table.releaseTransferBuffer = releaseTransferBufferThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, loadFormValue) && _SDM_HOST_DEFINES(Host, storeFormValue)) {
+            table.loadFormValue = loadFormValueThunk;
+            table.storeFormValue = storeFormValueThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, reportProgressEvent)) {
+            table.reportProgressEvent = reportProgressEventThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, declareMemoryRegion) && _SDM_HOST_DEFINES(Host, invalidateMemoryCache)) {
+            table.declareMemoryRegion = declareMemoryRegionThunk;
+            table.invalidateMemoryCache = invalidateMemoryCacheThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, openWriteStream) && _SDM_HOST_DEFINES(Host, writeStreamChunk)
+                && _SDM_HOST_DEFINES(Host, closeWriteStream)) {
+            table.openWriteStream = openWriteStreamThunk;
+            table.writeStreamChunk = writeStreamChunkThunk;
+            table.closeWriteStream = closeWriteStreamThunk;
+        }
+        if (_SDM_HOST_DEFINES(Host, beginTransactionGroup) && _SDM_HOST_DEFINES(Host, commitTransactionGroup)) {
+            table.beginTransactionGroup = beginTransactionGroupThunk;
+            table.commitTransactionGroup = commitTransactionGroupThunk;
+        }
+        return table;
+    }
+};
+
+/*!
+ * @brief Dispatcher that calls through an #SDMCallbacks table.
+ *
+ * This is the dispatcher for SDMs built as shared libraries. The `has...()` functions apply the rules for
+ * optional callbacks: the host's version must be at least v1.1 and the callback pointer must not be NULL.
+ */
+class SDMTableDispatch {
+public:
+    //! @brief Construct from the parameters passed to SDMOpen().
+    explicit SDMTableDispatch(const SDMOpenParameters &params)
+        : m_callbacks(params.callbacks),
+          m_refcon(params.refcon),
+          m_v11(params.version.major > 1 || (params.version.major == 1 && params.version.minor >= 1))
+    {
+    }
+
+    //! @name Optional callback queries
+    //@{
+    bool hasTransferMemoryBatch() const { return m_v11 && m_callbacks->transferMemoryBatch != NULL; }
+    bool hasAsyncIO() const
+    {
+        return m_v11 && m_callbacks->readMemoryAsync != NULL && m_callbacks->writeMemoryAsync != NULL
+            && m_callbacks->registerAccessAsync != NULL && m_callbacks->cancelAsyncRequest != NULL;
+    }
+    bool hasRegisterAccessEx() const { return m_v11 && m_callbacks->registerAccessEx != NULL; }
+    bool hasTransferBuffers() const
+    {
+        return m_v11 && m_callbacks->acquireTransferBuffer != NULL && m_callbacks->releaseTransferBuffer != NULL;
+    }
+    bool hasFormValueCache() const
+    {
+        return m_v11 && m_callbacks->loadFormValue != NULL && m_callbacks->storeFormValue != NULL;
+    }
+    bool hasProgressEvents() const { return m_v11 && m_callbacks->reportProgressEvent != NULL; }
+    bool hasMemoryRegions() const
+    {
+        return m_v11 && m_callbacks->declareMemoryRegion != NULL && m_callbacks->invalidateMemoryCache != NULL;
+    }
+    bool hasWriteStreams() const
+    {
+        return m_v11 && m_callbacks->openWriteStream != NULL && m_callbacks->writeStreamChunk != NULL
+            && m_callbacks->closeWriteStream != NULL;
+    }
+    bool hasTransactionGroups() const
+    {
+        return m_v11 && m_callbacks->beginTransactionGroup != NULL && m_callbacks->commitTransactionGroup != NULL;
+    }
+    //@}
+
+    //! @name Callbacks
+    //@{
+    void updateProgress(const char *progressMessage, uint8_t percentComplete) const
+    {
+        m_callbacks->updateProgress(progressMessage, percentComplete, m_refcon);
+    }
+    void setErrorMessage(const char *errorMessage, const char *errorDetails) const
+    {
+        m_callbacks->setErrorMessage(errorMessage, errorDetails, m_refcon);
+    }
+    SDMReturnCode resetStart(SDMResetType resetType) const { return m_callbacks->resetStart(resetType, m_refcon); }
+    SDMReturnCode resetFinish(SDMResetType resetType) const { return m_callbacks->resetFinish(resetType, m_refcon); }
+    SDMReturnCode readMemory(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, void *data) const
+    {
+        return m_callbacks->readMemory(device, address, transferSize, transferCount, attributes, data, m_refcon);
+    }
+    SDMReturnCode writeMemory(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, const void *data) const
+    {
+        return m_callbacks->writeMemory(device, address, transferSize, transferCount, attributes, data, m_refcon);
+    }
+    SDMReturnCode registerAccess(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, size_t *accessesCompleted) const
+    {
+        return m_callbacks->registerAccess(device, transferSize, accesses, accessCount, accessesCompleted, m_refcon);
+    }
+    SDMReturnCode presentForm(const SDMForm *form) const { return m_callbacks->presentForm(form, m_refcon); }
+    SDMReturnCode transferMemoryBatch(const SDMMemoryAccess *accesses, size_t accessCount,
+        size_t *accessesCompleted) const
+    {
+        return m_callbacks->transferMemoryBatch(accesses, accessCount, accessesCompleted, m_refcon);
+    }
+    SDMReturnCode readMemoryAsync(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, void *data, SDMIOCompletion completion, void *completionContext,
+        SDMRequestToken *token) const
+    {
+        return m_callbacks->readMemoryAsync(device, address, transferSize, transferCount, attributes, data,
+            completion, completionContext, token, m_refcon);
+    }
+    SDMReturnCode writeMemoryAsync(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, const void *value, SDMIOCompletion completion,
+        void *completionContext, SDMRequestToken *token) const
+    {
+        return m_callbacks->writeMemoryAsync(device, address, transferSize, transferCount, attributes, value,
+            completion, completionContext, token, m_refcon);
+    }
+    SDMReturnCode registerAccessAsync(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, SDMIOCompletion completion, void *completionContext,
+        SDMRequestToken *token) const
+    {
+        return m_callbacks->registerAccessAsync(device, transferSize, accesses, accessCount, completion,
+            completionContext, token, m_refcon);
+    }
+    SDMReturnCode cancelAsyncRequest(SDMRequestToken token) const
+    {
+        return m_callbacks->cancelAsyncRequest(token, m_refcon);
+    }
+    SDMReturnCode registerAccessEx(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccessEx *accesses, size_t accessCount, size_t *accessesCompleted) const
+    {
+        return m_callbacks->registerAccessEx(device, transferSize, accesses, accessCount, accessesCompleted, m_refcon);
+    }
+    SDMReturnCode acquireTransferBuffer(size_t size, void **buffer) const
+    {
+        return m_callbacks->acquireTransferBuffer(size, buffer, m_refcon);
+    }
+    void releaseTransferBuffer(void *buffer) const { m_callbacks->releaseTransferBuffer(buffer, m_refcon); }
+    SDMReturnCode loadFormValue(const char *formId, const char *elementId, char *buffer, size_t bufferLength) const
+    {
+        return m_callbacks->loadFormValue(formId, elementId, buffer, bufferLength, m_refcon);
+    }
+    SDMReturnCode storeFormValue(const char *formId, const char *elementId, const char *value) const
+    {
+        return m_callbacks->storeFormValue(formId, elementId, value, m_refcon);
+    }
+    void reportProgressEvent(const SDMProgressEvent *event) const { m_callbacks->reportProgressEvent(event, m_refcon); }
+    SDMReturnCode declareMemoryRegion(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size,
+        uint32_t attributes, SDMMemoryRegionKind kind) const
+    {
+        return m_callbacks->declareMemoryRegion(device, address, size, attributes, kind, m_refcon);
+    }
+    void invalidateMemoryCache(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size) const
+    {
+        m_callbacks->invalidateMemoryCache(device, address, size, m_refcon);
+    }
+    SDMReturnCode openWriteStream(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        uint32_t attributes, uint64_t totalSize, SDMWriteStream *stream) const
+    {
+        return m_callbacks->openWriteStream(device, address, transferSize, attributes, totalSize, stream, m_refcon);
+    }
+    SDMReturnCode writeStreamChunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags) const
+    {
+        return m_callbacks->writeStreamChunk(stream, data, size, flags, m_refcon);
+    }
+    SDMReturnCode closeWriteStream(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten) const
+    {
+        return m_callbacks->closeWriteStream(stream, abort, bytesWritten, m_refcon);
+    }
+    SDMReturnCode beginTransactionGroup(uint32_t flags) const
+    {
+        return m_callbacks->beginTransactionGroup(flags, m_refcon);
+    }
+    SDMReturnCode commitTransactionGroup(size_t *callsCompleted) const
+    {
+        return m_callbacks->commitTransactionGroup(callsCompleted, m_refcon);
+    }
+    //@}
+
+private:
+    const SDMCallbacks *m_callbacks;
+    void *m_refcon;
+    bool m_v11;
+};
+
+/*!
+ * @brief Dispatcher that calls a host class directly.
+ *
+ * For SDMs linked statically with a host derived from #SDMHost. Calls are ordinary member function calls, so
+ * the compiler can inline them. The `has...()` functions are evaluated at compile time from the member
+ * functions that the host defines.
+ *
+ * @tparam Host The host class, derived from `SDMHost<Host>`.
+ */
+template <class Host>
+class SDMDirectDispatch {
+public:
+    //! @brief Construct for a host instance, which must outlive the dispatcher.
+    explicit SDMDirectDispatch(Host &host) : m_host(host) { _SDM_HOST_CHECK_PAIRS(Host); }
+
+    //! @name Optional callback queries
+    //@{
+    static constexpr bool hasTransferMemoryBatch() { return _SDM_HOST_DEFINES(Host, transferMemoryBatch); }
+    static constexpr bool hasAsyncIO()
+    {
+        return _SDM_HOST_DEFINES(Host, readMemoryAsync) && _SDM_HOST_DEFINES(Host, writeMemoryAsync)
+            && _SDM_HOST_DEFINES(Host, registerAccessAsync) && _SDM_HOST_DEFINES(Host, cancelAsyncRequest);
+    }
+    static constexpr bool hasRegisterAccessEx() { return _SDM_HOST_DEFINES(Host, registerAccessEx); }
+    static constexpr bool hasTransferBuffers()
+    {
+        return _SDM_HOST_DEFINES(Host, acquireTransferBuffer) && _SDM_HOST_DEFINES(Host, releaseTransferBuffer);
+    }
+    static constexpr bool hasFormValueCache()
+    {
+        return _SDM_HOST_DEFINES(Host, loadFormValue) && _SDM_HOST_DEFINES(Host, storeFormValue);
+    }
+    static constexpr bool hasProgressEvents() { return _SDM_HOST_DEFINES(Host, reportProgressEvent); }
+    static constexpr bool hasMemoryRegions()
+    {
+        return _SDM_HOST_DEFINES(Host, declareMemoryRegion) && _SDM_HOST_DEFINES(Host, invalidateMemoryCache);
+    }
+    static constexpr bool hasWriteStreams()
+    {
+        return _SDM_HOST_DEFINES(Host, openWriteStream) && _SDM_HOST_DEFINES(Host, writeStreamChunk)
+            && _SDM_HOST_DEFINES(Host, closeWriteStream);
+    }
+    static constexpr bool hasTransactionGroups()
+    {
+        return _SDM_HOST_DEFINES(Host, beginTransactionGroup) && _SDM_HOST_DEFINES(Host, commitTransactionGroup);
+    }
+    //@}
+
+    //! @name Callbacks
+    //@{
+    void updateProgress(const char *progressMessage, uint8_t percentComplete) const
+    {
+        m_host.updateProgress(progressMessage, percentComplete);
+    }
+    void setErrorMessage(const char *errorMessage, const char *errorDetails) const
+    {
+        m_host.setErrorMessage(errorMessage, errorDetails);
+    }
+    SDMReturnCode resetStart(SDMResetType resetType) const { return m_host.resetStart(resetType); }
+    SDMReturnCode resetFinish(SDMResetType resetType) const { return m_host.resetFinish(resetType); }
+    SDMReturnCode readMemory(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, void *data) const
+    {
+        return m_host.readMemory(device, address, transferSize, transferCount, attributes, data);
+    }
+    SDMReturnCode writeMemory(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, const void *data) const
+    {
+        return m_host.writeMemory(device, address, transferSize, transferCount, attributes, data);
+    }
+    SDMReturnCode registerAccess(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, size_t *accessesCompleted) const
+    {
+        return m_host.registerAccess(device, transferSize, accesses, accessCount, accessesCompleted);
+    }
+    SDMReturnCode presentForm(const SDMForm *form) const { return m_host.presentForm(form); }
+    SDMReturnCode transferMemoryBatch(const SDMMemoryAccess *accesses, size_t accessCount,
+        size_t *accessesCompleted) const
+    {
+        return m_host.transferMemoryBatch(accesses, accessCount, accessesCompleted);
+    }
+    SDMReturnCode readMemoryAsync(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, void *data, SDMIOCompletion completion, void *completionContext,
+        SDMRequestToken *token) const
+    {
+        return m_host.readMemoryAsync(device, address, transferSize, transferCount, attributes, data, completion,
+            completionContext, token);
+    }
+    SDMReturnCode writeMemoryAsync(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        size_t transferCount, uint32_t attributes, const void *value, SDMIOCompletion completion,
+        void *completionContext, SDMRequestToken *token) const
+    {
+        return m_host.writeMemoryAsync(device, address, transferSize, transferCount, attributes, value, completion,
+            completionContext, token);
+    }
+    SDMReturnCode registerAccessAsync(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccess *accesses, size_t accessCount, SDMIOCompletion completion, void *completionContext,
+        SDMRequestToken *token) const
+    {
+        return m_host.registerAccessAsync(device, transferSize, accesses, accessCount, completion, completionContext,
+            token);
+    }
+    SDMReturnCode cancelAsyncRequest(SDMRequestToken token) const { return m_host.cancelAsyncRequest(token); }
+    SDMReturnCode registerAccessEx(const SDMDeviceDescriptor *device, SDMTransferSize transferSize,
+        const SDMRegisterAccessEx *accesses, size_t accessCount, size_t *accessesCompleted) const
+    {
+        return m_host.registerAccessEx(device, transferSize, accesses, accessCount, accessesCompleted);
+    }
+    SDMReturnCode acquireTransferBuffer(size_t size, void **buffer) const
+    {
+        return m_host.acquireTransferBuffer(size, buffer);
+    }
+    void releaseTransferBuffer(void *buffer) const { m_host.releaseTransferBuffer(buffer); }
+    SDMReturnCode loadFormValue(const char *formId, const char *elementId, char *buffer, size_t bufferLength) const
+    {
+        return m_host.loadFormValue(formId, elementId, buffer, bufferLength);
+    }
+    SDMReturnCode storeFormValue(const char *formId, const char *elementId, const char *value) const
+    {
+        return m_host.storeFormValue(formId, elementId, value);
+    }
+    void reportProgressEvent(const SDMProgressEvent *event) const { m_host.reportProgressEvent(event); }
+    SDMReturnCode declareMemoryRegion(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size,
+        uint32_t attributes, SDMMemoryRegionKind kind) const
+    {
+        return m_host.declareMemoryRegion(device, address, size, attributes, kind);
+    }
+    void invalidateMemoryCache(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size) const
+    {
+        m_host.invalidateMemoryCache(device, address, size);
+    }
+    SDMReturnCode openWriteStream(const SDMDeviceDescriptor *device, uint64_t address, SDMTransferSize transferSize,
+        uint32_t attributes, uint64_t totalSize, SDMWriteStream *stream) const
+    {
+        return m_host.openWriteStream(device, address, transferSize, attributes, totalSize, stream);
+    }
+    SDMReturnCode writeStreamChunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags) const
+    {
+        return m_host.writeStreamChunk(stream, data, size, flags);
+    }
+    SDMReturnCode closeWriteStream(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten) const
+    {
+        return m_host.closeWriteStream(stream, abort, bytesWritten);
+    }
+    SDMReturnCode beginTransactionGroup(uint32_t flags) const { return m_host.beginTransactionGroup(flags); }
+    SDMReturnCode commitTransactionGroup(size_t *callsCompleted) const
+    {
+        return m_host.commitTransactionGroup(callsCompleted);
+    }
+    //@}
+
+private:
+    Host &m_host;
+};
+
+/** @} */
+
+#endif /* _SECURE_DEBUG_MANAGER_HPP_ */
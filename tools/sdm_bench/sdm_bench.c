@@ -0,0 +1,578 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @file
+ *
+ * @brief Benchmark driver for SDM implementations.
+ *
+ * Loads an SDM shared library, then repeatedly opens, authenticates, and closes it against the simulated
+ * debug link. Reports latency percentiles for each stage and the average callback traffic per iteration.
+ *
+ * Reported times are the sum of the measured wall-clock time and the modelled link time, unless the link runs
+ * in real-time mode, in which case the wall-clock time already includes the link time.
+ *
+ * The callback traffic can be recorded to a trace file, or served from a trace file recorded earlier, using the
+ * shim and replay driver in `tools/sdm_trace`.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim_link.h"
+#include "trace_recorder.h"
+#include "trace_replay.h"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef SDMReturnCode (*SDMOpenFn)(SDMHandle *handle, const SDMOpenParameters *params);
+typedef SDMReturnCode (*SDMAuthenticateFn)(SDMHandle handle, const SDMAuthenticateParameters *params);
+typedef SDMReturnCode (*SDMCloseFn)(SDMHandle handle);
+typedef SDMReturnCode (*SDMGetStatisticsFn)(SDMHandle handle, SDMStatistics *statistics, SDMBool reset);
+typedef SDMReturnCode (*SDMReattachFn)(SDMHandle handle, SDMConnectMode connectMode);
+typedef SDMReturnCode (*SDMQueryCapabilitiesFn)(SDMHandle handle, SDMCapabilities *capabilities);
+
+// The stages of one benchmark iteration.
+enum {
+    kStageOpen,
+    kStageAuthenticate,
+    kStageClose,
+    kStageTotal,
+    kStageCount,
+};
+
+static const char *kStageNames[kStageCount] = { "open", "authenticate", "close", "total" };
+
+static const char *kPhaseNames[] = {
+    "other", "discovery", "credential-load", "challenge-request",
+    "signature", "certificate-transfer", "response", "resume-boot",
+    "reset",
+};
+
+static const char *kCallbackNames[] = {
+    "updateProgress", "setErrorMessage", "resetStart", "resetFinish",
+    "readMemory", "writeMemory", "registerAccess", "presentForm",
+    "transferMemoryBatch", "readMemoryAsync", "writeMemoryAsync", "registerAccessAsync",
+    "cancelAsyncRequest", "registerAccessEx", "acquireTransferBuffer", "releaseTransferBuffer",
+    "loadFormValue", "storeFormValue", "reportProgressEvent", "declareMemoryRegion",
+    "invalidateMemoryCache", "openWriteStream", "writeStreamChunk", "closeWriteStream",
+    "beginTransactionGroup", "commitTransactionGroup",
+};
+
+// Names of the SDMCapabilityFlagsEnum bits, indexed by bit number.
+static const char *kCapabilityNames[32] = {
+    [0] = "resume-boot", [1] = "multiple-authentications", [2] = "resumable-authentication",
+    [3] = "authentication-cache", [4] = "multi-device-authentication", [5] = "reattach",
+    [6] = "prepare-during-reset", [7] = "thread-safe-handles", [8] = "statistics",
+    [16] = "memory-batch", [17] = "async-io", [18] = "register-access-ex", [19] = "transfer-buffers",
+    [20] = "write-streams", [21] = "transaction-groups", [22] = "memory-regions", [23] = "progress-events",
+    [24] = "form-value-cache",
+};
+
+//! Maximum number of form answers accepted on the command line.
+#define MAX_FORM_ANSWERS 32
+
+typedef struct BenchOptions {
+    unsigned iterations;
+    const char *libraryPath;
+    const char *manifestPath;
+    const char *resourcesPath;
+    SDMConnectMode connectMode;
+    SDMDebugArchitecture architecture;
+    SimLinkConfig link;
+    SDMBool reattach;
+    SDMBool topology;
+    const char *recordPath;
+    const char *replayPath;
+    SDMFormAnswer formAnswers[MAX_FORM_ANSWERS];
+    size_t formAnswerCount;
+} BenchOptions;
+
+static uint64_t monotonicNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static int compareU64(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted sample array.
+static uint64_t percentile(const uint64_t *sorted, size_t count, unsigned pct)
+{
+    size_t rank = (count * pct + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+// Trace timestamps include the modelled link time, so that a trace recorded against the simulated link has the
+// same timing as the benchmark's stage measurements.
+static uint64_t traceClock(void *context)
+{
+    const SimLink *link = (const SimLink *)context;
+    return monotonicNs() + (link->config.realTime ? 0 : link->nowNs);
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+        "usage: %s [options] <sdm-library>\n"
+        "  -n <count>    iterations (default 100)\n"
+        "  -m <path>     manifest file path\n"
+        "  -r <path>     resources directory path (default: manifest directory)\n"
+        "  -c <mode>     connect mode: load, restart, attach (default load)\n"
+        "  -6            ADIv6 debug architecture (default ADIv5)\n"
+        "  -l <us>       latency per probe transaction in microseconds (default 1000)\n"
+        "  -b <bytes/s>  link bandwidth, 0 for unlimited (default 1000000)\n"
+        "  -p <ns>       probe poll read interval in nanoseconds (default 1000)\n"
+        "  -d <us>       mailbox response delay in microseconds (default 100)\n"
+        "  -R <us>       target reset duration in microseconds (default 10000)\n"
+        "  -s            sleep for modelled link time (real-time mode)\n"
+        "  -a <answer>   form answer, as [form.]element=value (repeatable)\n"
+        "  -A            reattach with SDMReattach() instead of close and open, if exported\n"
+        "  -O            overlapped reset: authenticate with prepare-during-reset\n"
+        "  -C            cache reads of memory regions declared immutable\n"
+        "  -T            pass the simulated target topology to SDMOpen()\n"
+        "  -w <path>     record the callback traffic to a trace file\n"
+        "  -P <path>     serve the callback traffic from a trace file\n",
+        program);
+}
+
+// Split "[form.]element=value" in place into a form answer.
+static int parseFormAnswer(char *text, SDMFormAnswer *answer)
+{
+    char *equals = strchr(text, '=');
+    if (equals == NULL || equals == text) {
+        return -1;
+    }
+    *equals = '\0';
+    char *dot = strchr(text, '.');
+    if (dot != NULL) {
+        *dot = '\0';
+        answer->formId = text;
+        answer->elementId = dot + 1;
+    }
+    else {
+        answer->formId = NULL;
+        answer->elementId = text;
+    }
+    answer->value = equals + 1;
+    return 0;
+}
+
+static int parseOptions(int argc, char **argv, BenchOptions *options)
+{
+    int opt;
+    memset(options, 0, sizeof(*options));
+    options->iterations = 100;
+    options->connectMode = SDMConnectMode_Load;
+    options->architecture = SDMDebugArchitecture_ArmADIv5;
+    simLinkDefaultConfig(&options->link);
+
+    while ((opt = getopt(argc, argv, "n:m:r:c:6l:b:p:d:R:sa:AOCTw:P:")) != -1) {
+        switch (opt) {
+        case 'n': options->iterations = (unsigned)strtoul(optarg, NULL, 0); break;
+        case 'm': options->manifestPath = optarg; break;
+        case 'r': options->resourcesPath = optarg; break;
+        case 'c':
+            if (strcmp(optarg, "load") == 0) {
+                options->connectMode = SDMConnectMode_Load;
+            }
+            else if (strcmp(optarg, "restart") == 0) {
+                options->connectMode = SDMConnectMode_Restart;
+            }
+            else if (strcmp(optarg, "attach") == 0) {
+                options->connectMode = SDMConnectMode_Attach;
+            }
+            else {
+                return -1;
+            }
+            break;
+        case '6': options->architecture = SDMDebugArchitecture_ArmADIv6; break;
+        case 'l': options->link.transactionLatencyNs = strtoull(optarg, NULL, 0) * 1000u; break;
+        case 'b': options->link.bytesPerSecond = strtoull(optarg, NULL, 0); break;
+        case 'p': options->link.pollIntervalNs = strtoull(optarg, NULL, 0); break;
+        case 'd': options->link.responseDelayNs = strtoull(optarg, NULL, 0) * 1000u; break;
+        case 'R': options->link.resetNs = strtoull(optarg, NULL, 0) * 1000u; break;
+        case 's': options->link.realTime = true; break;
+        case 'A': options->reattach = true; break;
+        case 'O': options->link.overlappedReset = true; break;
+        case 'C': options->link.readCache = true; break;
+        case 'T': options->topology = true; break;
+        case 'w': options->recordPath = optarg; break;
+        case 'P': options->replayPath = optarg; break;
+        case 'a':
+            if (options->formAnswerCount == MAX_FORM_ANSWERS
+                    || parseFormAnswer(optarg, &options->formAnswers[options->formAnswerCount]) != 0) {
+                return -1;
+            }
+            options->formAnswerCount++;
+            break;
+        default: return -1;
+        }
+    }
+    if (optind != argc - 1 || options->iterations == 0
+            || (options->recordPath != NULL && options->replayPath != NULL)) {
+        return -1;
+    }
+    options->libraryPath = argv[optind];
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (parseOptions(argc, argv, &options) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    void *library = dlopen(options.libraryPath, RTLD_NOW | RTLD_LOCAL);
+    if (library == NULL) {
+        fprintf(stderr, "error: %s\n", dlerror());
+        return 1;
+    }
+    // Function pointers are assigned through an object pointer, the form POSIX recommends for dlsym().
+    SDMOpenFn sdmOpen;
+    SDMAuthenticateFn sdmAuthenticate;
+    SDMCloseFn sdmClose;
+    SDMGetStatisticsFn sdmGetStatistics;
+    SDMReattachFn sdmReattach;
+    SDMQueryCapabilitiesFn sdmQueryCapabilities;
+    *(void **)&sdmOpen = dlsym(library, "SDMOpen");
+    *(void **)&sdmAuthenticate = dlsym(library, "SDMAuthenticate");
+    *(void **)&sdmClose = dlsym(library, "SDMClose");
+    *(void **)&sdmGetStatistics = dlsym(library, "SDMGetStatistics");
+    *(void **)&sdmReattach = dlsym(library, "SDMReattach");
+    *(void **)&sdmQueryCapabilities = dlsym(library, "SDMQueryCapabilities");
+    if (sdmOpen == NULL || sdmAuthenticate == NULL || sdmClose == NULL) {
+        fprintf(stderr, "error: %s does not export the SDM API\n", options.libraryPath);
+        return 1;
+    }
+    if (options.reattach && sdmReattach == NULL) {
+        fprintf(stderr, "warning: %s does not export SDMReattach(), using close and open\n", options.libraryPath);
+        options.reattach = false;
+    }
+
+    // Default the resources directory to the manifest's directory.
+    char *resourcesPath = NULL;
+    if (options.resourcesPath == NULL && options.manifestPath != NULL) {
+        resourcesPath = strdup(options.manifestPath);
+        char *slash = resourcesPath != NULL ? strrchr(resourcesPath, '/') : NULL;
+        if (slash != NULL) {
+            *slash = '\0';
+        }
+        options.resourcesPath = resourcesPath;
+    }
+
+    SimLink *link = (SimLink *)malloc(sizeof(SimLink));
+    uint64_t *samples = (uint64_t *)calloc((size_t)options.iterations * kStageCount, sizeof(uint64_t));
+    if (link == NULL || samples == NULL || simLinkInit(link, &options.link) != SDMReturnCode_Success) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+
+    static const char *locales[] = { "en-US", NULL };
+    SDMOpenParameters openParams;
+    memset(&openParams, 0, sizeof(openParams));
+    openParams.version.major = SDMVersion_CurrentMajor;
+    openParams.version.minor = SDMVersion_CurrentMinor;
+    openParams.debugArchitecture = options.architecture;
+    openParams.callbacks = &link->callbacks;
+    openParams.refcon = link;
+    openParams.resourcesDirectoryPath = options.resourcesPath;
+    openParams.manifestFilePath = options.manifestPath;
+    openParams.locales = locales;
+    openParams.connectMode = options.connectMode;
+    openParams.hostCapabilities = &link->capabilities;
+    openParams.formAnswers = options.formAnswerCount != 0 ? options.formAnswers : NULL;
+    openParams.formAnswerCount = options.formAnswerCount;
+    openParams.topology = options.topology ? &link->topology : NULL;
+
+    TraceRecorder recorder;
+    TraceReplay replay;
+    memset(&replay, 0, sizeof(replay));
+    if (options.recordPath != NULL) {
+        if (traceRecorderInit(&recorder, options.recordPath, &openParams, traceClock, link) != SDMReturnCode_Success) {
+            fprintf(stderr, "error: cannot create %s\n", options.recordPath);
+            return 1;
+        }
+        openParams.callbacks = &recorder.callbacks;
+        openParams.refcon = &recorder;
+    }
+    else if (options.replayPath != NULL) {
+        if (traceReplayInit(&replay, options.replayPath, &link->callbacks, link) != SDMReturnCode_Success) {
+            fprintf(stderr, "error: cannot load trace %s\n", options.replayPath);
+            return 1;
+        }
+        openParams.callbacks = &replay.callbacks;
+        openParams.refcon = &replay;
+    }
+
+    SDMAuthenticateParameters authParams;
+    memset(&authParams, 0, sizeof(authParams));
+    authParams.isLastAuthentication = true;
+    if (options.link.overlappedReset) {
+        authParams.flags |= SDMAuthenticateFlags_PrepareDuringReset;
+    }
+
+    SDMStatistics totalStatistics;
+    memset(&totalStatistics, 0, sizeof(totalStatistics));
+    SDMBool haveStatistics = false;
+    SDMCapabilities capabilities;
+    memset(&capabilities, 0, sizeof(capabilities));
+    SDMBool haveCapabilities = false;
+
+    // In reattach mode the handle is kept open across iterations. The open stage measures SDMReattach() and
+    // the close stage is only performed by the last iteration.
+    // Only the samples of successful iterations are kept, so that the stages a failed iteration did not reach
+    // do not lower the percentiles. _completed_ counts the kept rows of _samples_.
+    unsigned failures = 0;
+    unsigned completed = 0;
+    SDMHandle handle = NULL;
+    for (unsigned i = 0; i < options.iterations; ++i) {
+        uint64_t *sample = &samples[(size_t)completed * kStageCount];
+        memset(sample, 0, kStageCount * sizeof(uint64_t));
+        const SDMBool keepOpen = options.reattach && i + 1 < options.iterations;
+        const SDMBool reattaching = handle != NULL;
+        SDMReturnCode result;
+
+        for (int stage = kStageOpen; stage <= kStageClose; ++stage) {
+            const uint64_t wallStart = monotonicNs();
+            const uint64_t linkStart = link->nowNs;
+            const uint64_t replayStart = replay.linkNs;
+            const uint64_t traceStart = options.recordPath != NULL ? traceRecorderNow(&recorder) : 0;
+            uint32_t api = SDMTraceApi_Close;
+            switch (stage) {
+            case kStageOpen:
+                if (reattaching) {
+                    api = SDMTraceApi_Reattach;
+                    result = sdmReattach(handle, options.connectMode);
+                }
+                else {
+                    api = SDMTraceApi_Open;
+                    result = sdmOpen(&handle, &openParams);
+                }
+                break;
+            case kStageAuthenticate:
+                api = SDMTraceApi_Authenticate;
+                result = sdmAuthenticate(handle, &authParams);
+                break;
+            default:
+                result = SDMReturnCode_Success;
+                if (!keepOpen) {
+                    result = sdmClose(handle);
+                    handle = NULL;
+                }
+                else {
+                    api = 0;
+                }
+                break;
+            }
+            if (options.recordPath != NULL && api != 0) {
+                traceRecorderApiCall(&recorder, api, result, traceStart);
+            }
+            sample[stage] = monotonicNs() - wallStart;
+            if (!options.link.realTime) {
+                sample[stage] += link->nowNs - linkStart;
+            }
+            // Calls served from a trace cost their recorded duration, without sleeping.
+            sample[stage] += replay.linkNs - replayStart;
+            sample[kStageTotal] += sample[stage];
+
+            // Statistics and capabilities are read outside the timed region.
+            if (result == SDMReturnCode_Success && stage == kStageAuthenticate && sdmGetStatistics != NULL) {
+                SDMStatistics statistics;
+                memset(&statistics, 0, sizeof(statistics));
+                statistics.structSize = sizeof(statistics);
+                // Reset on each read, since in reattach mode the handle and its counters persist across
+                // iterations.
+                if (sdmGetStatistics(handle, &statistics, true) == SDMReturnCode_Success) {
+                    for (unsigned p = 0; p < SDMStatistics_MaxPhases; ++p) {
+                        totalStatistics.phaseTimeNs[p] += statistics.phaseTimeNs[p];
+                    }
+                    totalStatistics.pollRetries += statistics.pollRetries;
+                    haveStatistics = true;
+                }
+            }
+            // Capabilities are read once, after the SDM has learned about the target.
+            if (result == SDMReturnCode_Success && stage == kStageAuthenticate && sdmQueryCapabilities != NULL
+                    && !haveCapabilities) {
+                capabilities.structSize = sizeof(capabilities);
+                haveCapabilities = sdmQueryCapabilities(handle, &capabilities) == SDMReturnCode_Success;
+            }
+
+            if (result != SDMReturnCode_Success) {
+                fprintf(stderr, "iteration %u: %s failed with %u\n", i, kStageNames[stage], (unsigned)result);
+                failures++;
+                if (stage == kStageAuthenticate || (stage == kStageOpen && reattaching)) {
+                    sdmClose(handle);
+                }
+                handle = NULL;
+                break;
+            }
+        }
+        if (result == SDMReturnCode_Success) {
+            completed++;
+        }
+    }
+
+    printf("%u iterations, %u failed\n\n", options.iterations, failures);
+    printf("%-14s %12s %12s %12s %12s %12s\n", "stage (us)", "min", "p50", "p90", "p99", "max");
+    uint64_t *sorted = (uint64_t *)malloc((size_t)options.iterations * sizeof(uint64_t));
+    for (int stage = 0; sorted != NULL && completed != 0 && stage < kStageCount; ++stage) {
+        for (unsigned i = 0; i < completed; ++i) {
+            sorted[i] = samples[(size_t)i * kStageCount + stage];
+        }
+        qsort(sorted, completed, sizeof(uint64_t), compareU64);
+        printf("%-14s %12.1f %12.1f %12.1f %12.1f %12.1f\n", kStageNames[stage],
+            sorted[0] / 1000.0,
+            percentile(sorted, completed, 50) / 1000.0,
+            percentile(sorted, completed, 90) / 1000.0,
+            percentile(sorted, completed, 99) / 1000.0,
+            sorted[completed - 1] / 1000.0);
+    }
+
+    const double n = options.iterations;
+    printf("\nper iteration:\n");
+    printf("  %-22s %12.1f\n", "probe transactions", link->counters.transactions / n);
+    printf("  %-22s %12.1f\n", "bytes read", link->counters.bytesRead / n);
+    printf("  %-22s %12.1f\n", "bytes written", link->counters.bytesWritten / n);
+    printf("  %-22s %12.1f\n", "probe poll reads", link->counters.pollReads / n);
+    if (options.link.readCache) {
+        printf("  %-22s %12.1f\n", "read cache hits", link->counters.readCacheHits / n);
+    }
+    if (options.link.overlappedReset) {
+        printf("  %-22s %12.1f\n", "reset overlap (us)", link->counters.resetOverlapNs / n / 1000.0);
+    }
+    if (link->counters.groupedCalls != 0) {
+        printf("  %-22s %12.1f\n", "grouped calls", link->counters.groupedCalls / n);
+    }
+    for (size_t id = 0; id < sizeof(kCallbackNames) / sizeof(kCallbackNames[0]); ++id) {
+        if (link->counters.callbackCount[id] != 0) {
+            printf("  %-22s %12.1f\n", kCallbackNames[id], link->counters.callbackCount[id] / n);
+        }
+    }
+    if (link->counters.mailboxUnderflows != 0 || link->counters.mailboxOverflows != 0) {
+        printf("  mailbox underflows %llu, overflows %llu\n",
+            (unsigned long long)link->counters.mailboxUnderflows,
+            (unsigned long long)link->counters.mailboxOverflows);
+    }
+
+    SDMBool havePhaseEvents = false;
+    for (size_t p = 0; p < SDMStatistics_MaxPhases; ++p) {
+        havePhaseEvents = havePhaseEvents || link->counters.phaseNs[p] != 0;
+    }
+    if (havePhaseEvents) {
+        printf("\nprogress event phase times per iteration (us, bytes):\n");
+        for (size_t p = 0; p < sizeof(kPhaseNames) / sizeof(kPhaseNames[0]); ++p) {
+            if (link->counters.phaseNs[p] != 0 || link->counters.phaseBytes[p] != 0) {
+                printf("  %-22s %12.1f %12.1f\n", kPhaseNames[p], link->counters.phaseNs[p] / n / 1000.0,
+                    link->counters.phaseBytes[p] / n);
+            }
+        }
+    }
+
+    if (haveCapabilities) {
+        printf("\nSDM session capabilities: 0x%08x\n ", (unsigned)capabilities.flags);
+        for (unsigned bit = 0; bit < 32; ++bit) {
+            if ((capabilities.flags & (1u << bit)) != 0 && kCapabilityNames[bit] != NULL) {
+                printf(" %s", kCapabilityNames[bit]);
+            }
+        }
+        printf("\n");
+        const struct {
+            const char *name;
+            uint64_t value;
+        } limits[] = {
+            { "devices per auth", capabilities.maxDevicesPerAuthentication },
+            { "auth cache lifetime (s)", capabilities.authenticationCacheLifetimeS },
+            { "register accesses/call", capabilities.maxRegisterAccessesPerCall },
+            { "memory batch size", capabilities.maxMemoryBatchSize },
+            { "async requests", capabilities.maxAsyncRequestsInFlight },
+            { "stream chunks queued", capabilities.maxWriteStreamChunksInFlight },
+            { "max transfer size", capabilities.maxTransferSize },
+        };
+        for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i) {
+            if (limits[i].value != 0) {
+                printf("  %-22s %12llu\n", limits[i].name, (unsigned long long)limits[i].value);
+            }
+        }
+    }
+
+    if (haveStatistics) {
+        printf("\nSDM-reported phase times per iteration (us):\n");
+        for (size_t p = 0; p < sizeof(kPhaseNames) / sizeof(kPhaseNames[0]); ++p) {
+            if (totalStatistics.phaseTimeNs[p] != 0) {
+                printf("  %-22s %12.1f\n", kPhaseNames[p], totalStatistics.phaseTimeNs[p] / n / 1000.0);
+            }
+        }
+        printf("  %-22s %12.1f\n", "poll retries", totalStatistics.pollRetries / n);
+    }
+
+    if (options.replayPath != NULL) {
+        printf("\nreplay:\n");
+        printf("  %-22s %12.1f\n", "calls served", replay.served / n);
+        printf("  %-22s %12.1f\n", "calls forwarded", replay.forwarded / n);
+        printf("  %-22s %12.1f\n", "recorded link (us)", replay.linkNs / n / 1000.0);
+        if (replay.diverged && replay.exhausted) {
+            printf("  trace exhausted after record %llu\n", (unsigned long long)replay.divergedRecord);
+        }
+        else if (replay.diverged) {
+            printf("  diverged at record %llu, on a call of %s\n", (unsigned long long)replay.divergedRecord,
+                replay.divergedCallback < sizeof(kCallbackNames) / sizeof(kCallbackNames[0])
+                    ? kCallbackNames[replay.divergedCallback] : "unknown callback");
+        }
+        traceReplayDestroy(&replay);
+    }
+    if (options.recordPath != NULL && traceRecorderFinish(&recorder) != SDMReturnCode_Success) {
+        fprintf(stderr, "error: the trace %s is incomplete\n", options.recordPath);
+        failures++;
+    }
+
+    free(sorted);
+    free(samples);
+    simLinkDestroy(link);
+    free(link);
+    free(resourcesPath);
+    dlclose(library);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,975 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim_link.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Alignment of transfer buffers, which are allocated with malloc().
+#define SIM_TRANSFER_BUFFER_ALIGNMENT 8u
+
+// Write stream chunking and queuing advertised to the SDM.
+#define SIM_WRITE_CHUNK_SIZE 1024u
+#define SIM_WRITE_QUEUE_DEPTH 8u
+
+// Representative ID register values for the simulated APs. These are not the values of a particular product.
+#define SIM_MEM_AP_IDR 0x24770011u
+#define SIM_MAILBOX_AP_IDR 0x63780001u
+
+// Upper limit on poll reads for a poll with a retry count of zero, so a broken SDM cannot hang the benchmark.
+#define SIM_POLL_READ_LIMIT 10000000u
+
+static uint64_t wallNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static void advance(SimLink *link, uint64_t ns)
+{
+    link->nowNs += ns;
+    if (link->config.realTime && ns > 0) {
+        struct timespec delay = {
+            .tv_sec = (time_t)(ns / 1000000000u),
+            .tv_nsec = (long)(ns % 1000000000u),
+        };
+        nanosleep(&delay, NULL);
+    }
+}
+
+// Charge the time to move payload bytes over the link.
+static void payload(SimLink *link, uint64_t bytesRead, uint64_t bytesWritten)
+{
+    link->counters.bytesRead += bytesRead;
+    link->counters.bytesWritten += bytesWritten;
+    if (link->config.bytesPerSecond != 0) {
+        advance(link, (bytesRead + bytesWritten) * 1000000000u / link->config.bytesPerSecond);
+    }
+}
+
+// Charge one probe transaction moving the given number of payload bytes. Within a transaction group only the
+// payload is charged; the commit pays the latency for the whole group.
+static void transaction(SimLink *link, SDMCallbackId id, uint64_t bytesRead, uint64_t bytesWritten)
+{
+    link->counters.callbackCount[id]++;
+    if (!link->groupActive) {
+        link->counters.transactions++;
+        advance(link, link->config.transactionLatencyNs);
+    }
+    payload(link, bytesRead, bytesWritten);
+}
+
+// Account for the result of a call that may be made within a transaction group. Only calls that succeed
+// before the group's first failure count as completed, and the first failure is returned by the commit.
+static SDMReturnCode groupCall(SimLink *link, SDMReturnCode result)
+{
+    if (link->groupActive) {
+        link->counters.groupedCalls++;
+        if (link->groupError == SDMReturnCode_Success) {
+            if (result == SDMReturnCode_Success) {
+                link->groupCalls++;
+            }
+            else {
+                link->groupError = result;
+            }
+        }
+    }
+    return result;
+}
+
+static uint32_t mailboxStatus(const SimLink *link, uint64_t atNs)
+{
+    uint32_t status = SimMailboxStatus_TxReady;
+    if (link->rxCount > 0 && link->rxFifo[link->rxHead].readyNs <= atNs) {
+        status |= SimMailboxStatus_RxReady;
+    }
+    return status;
+}
+
+static uint32_t mailboxReadData(SimLink *link)
+{
+    if ((mailboxStatus(link, link->nowNs) & SimMailboxStatus_RxReady) == 0) {
+        link->counters.mailboxUnderflows++;
+        return 0;
+    }
+    const uint32_t word = link->rxFifo[link->rxHead].word;
+    link->rxHead = (link->rxHead + 1) % SIM_MAILBOX_FIFO_WORDS;
+    link->rxCount--;
+    return word;
+}
+
+static void echoResponder(SimLink *link, uint32_t word, void *context)
+{
+    (void)context;
+    simLinkMailboxPost(link, word);
+}
+
+// Resolve a memory transfer to a pointer into RAM.
+static SDMReturnCode resolveMemory(
+    SimLink *link,
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint8_t **ptr,
+    uint64_t *length)
+{
+    if (device == NULL) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    switch (transferSize) {
+    case SDMTransferSize_8:
+    case SDMTransferSize_16:
+    case SDMTransferSize_32:
+    case SDMTransferSize_64:
+        break;
+    default:
+        return SDMReturnCode_UnsupportedTransferSize;
+    }
+    const uint64_t unit = transferSize / 8;
+    if ((address % unit) != 0) {
+        return SDMReturnCode_InvalidArgument;
+    }
+
+    const SDMDeviceDescriptor *memAp = device;
+    if (device->deviceType == SDMDeviceType_ArmADI_CoreSightComponent) {
+        memAp = device->armCoreSightComponent.memAp;
+        address += device->armCoreSightComponent.baseAddress;
+    }
+    if (memAp == NULL || memAp->deviceType != SDMDeviceType_ArmADI_AP
+            || memAp->armAP.address != link->config.memApIndex) {
+        return SDMReturnCode_TransferFault;
+    }
+
+    *length = unit * transferCount;
+    if (address < link->config.memoryBase
+            || address - link->config.memoryBase > link->config.memorySize
+            || *length > link->config.memorySize - (address - link->config.memoryBase)) {
+        return SDMReturnCode_TransferFault;
+    }
+    *ptr = link->memory + (address - link->config.memoryBase);
+    return SDMReturnCode_Success;
+}
+
+static void updateProgress(const char *progressMessage, uint8_t percentComplete, void *refcon)
+{
+    (void)progressMessage;
+    (void)percentComplete;
+    ((SimLink *)refcon)->counters.callbackCount[SDMCallbackId_UpdateProgress]++;
+}
+
+static void setErrorMessage(const char *errorMessage, const char *errorDetails, void *refcon)
+{
+    (void)errorMessage;
+    (void)errorDetails;
+    ((SimLink *)refcon)->counters.callbackCount[SDMCallbackId_SetErrorMessage]++;
+}
+
+// Discard read cache contents for a range of RAM offsets.
+static void invalidateRange(SimLink *link, uint64_t offset, uint64_t length)
+{
+    if (!link->cacheEmpty) {
+        memset(link->cached + offset, 0, (size_t)length);
+    }
+}
+
+static void invalidateAll(SimLink *link)
+{
+    if (link->cached != NULL && !link->cacheEmpty) {
+        memset(link->cached, 0, link->config.memorySize);
+        link->cacheEmpty = true;
+    }
+}
+
+// Returns true if every byte of the range is held in the read cache.
+static SDMBool rangeCached(const SimLink *link, uint64_t offset, uint64_t length)
+{
+    if (link->cached == NULL || link->cacheEmpty || length == 0) {
+        return false;
+    }
+    for (uint64_t i = 0; i < length; ++i) {
+        if (link->cached[offset + i] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Record a completed read in the read cache.
+static void fillRange(SimLink *link, uint64_t offset, uint64_t length)
+{
+    if (link->cached == NULL) {
+        return;
+    }
+    for (uint64_t i = 0; i < length; ++i) {
+        if (link->cacheable[offset + i] != 0) {
+            link->cached[offset + i] = 1;
+            link->cacheEmpty = false;
+        }
+    }
+}
+
+static SDMReturnCode resetStart(SDMResetType resetType, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    (void)resetType;
+    transaction(link, SDMCallbackId_ResetStart, 0, 0);
+    link->rxHead = 0;
+    link->rxCount = 0;
+    invalidateAll(link);
+    if (link->config.overlappedReset) {
+        // The reset proceeds in the background; resetFinish() waits for what remains of it.
+        link->resetStartWallNs = wallNs();
+        link->resetStartLinkNs = link->nowNs;
+        return SDMReturnCode_Success;
+    }
+    advance(link, link->config.resetNs / 2);
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode resetFinish(SDMResetType resetType, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    (void)resetType;
+    transaction(link, SDMCallbackId_ResetFinish, 0, 0);
+    if (link->config.overlappedReset) {
+        // In real-time mode the wall clock already includes the modelled link time.
+        uint64_t elapsed = wallNs() - link->resetStartWallNs;
+        if (!link->config.realTime) {
+            elapsed += link->nowNs - link->resetStartLinkNs;
+        }
+        if (elapsed < link->config.resetNs) {
+            link->counters.resetOverlapNs += elapsed;
+            advance(link, link->config.resetNs - elapsed);
+        }
+        else {
+            link->counters.resetOverlapNs += link->config.resetNs;
+        }
+        return SDMReturnCode_Success;
+    }
+    advance(link, link->config.resetNs - link->config.resetNs / 2);
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode readMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    uint8_t *ptr = NULL;
+    uint64_t length = 0;
+    // Simulated RAM does not depend on the transfer attributes, so cache entries are not keyed on them.
+    (void)attributes;
+    SDMReturnCode result = resolveMemory(link, device, address, transferSize, transferCount, &ptr, &length);
+    if (result == SDMReturnCode_Success && rangeCached(link, (uint64_t)(ptr - link->memory), length)) {
+        link->counters.callbackCount[SDMCallbackId_ReadMemory]++;
+        link->counters.readCacheHits++;
+        memcpy(data, ptr, (size_t)length);
+        return groupCall(link, result);
+    }
+    transaction(link, SDMCallbackId_ReadMemory, result == SDMReturnCode_Success ? length : 0, 0);
+    if (result == SDMReturnCode_Success) {
+        memcpy(data, ptr, (size_t)length);
+        fillRange(link, (uint64_t)(ptr - link->memory), length);
+    }
+    return groupCall(link, result);
+}
+
+static SDMReturnCode writeMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    uint8_t *ptr = NULL;
+    uint64_t length = 0;
+    (void)attributes;
+    SDMReturnCode result = resolveMemory(link, device, address, transferSize, transferCount, &ptr, &length);
+    transaction(link, SDMCallbackId_WriteMemory, 0, result == SDMReturnCode_Success ? length : 0);
+    if (result == SDMReturnCode_Success) {
+        memcpy(ptr, value, (size_t)length);
+        invalidateRange(link, (uint64_t)(ptr - link->memory), length);
+    }
+    return groupCall(link, result);
+}
+
+// Perform one register access without charging a transaction.
+static SDMReturnCode performRegisterAccess(SimLink *link, SDMBool isMailbox, const SDMRegisterAccessEx *access)
+{
+    if (access->value == NULL) {
+        return SDMReturnCode_InvalidArgument;
+    }
+
+    // Only 32-bit registers are simulated, so values are always uint32_t.
+    uint32_t *value = (uint32_t *)access->value;
+
+    switch (access->op) {
+    case SDMRegisterAccessOp_Read:
+        payload(link, 4, 0);
+        if (!isMailbox) {
+            *value = 0;
+        }
+        else if (access->address == link->config.mailboxDataOffset) {
+            *value = mailboxReadData(link);
+        }
+        else if (access->address == link->config.mailboxStatusOffset) {
+            *value = mailboxStatus(link, link->nowNs);
+        }
+        else {
+            *value = 0;
+        }
+        return SDMReturnCode_Success;
+
+    case SDMRegisterAccessOp_Write:
+        payload(link, 0, 4);
+        if (isMailbox && access->address == link->config.mailboxDataOffset && link->responder != NULL) {
+            link->responder(link, *value, link->responderContext);
+        }
+        return SDMReturnCode_Success;
+
+    case SDMRegisterAccessOp_WriteBlock:
+    case SDMRegisterAccessOp_ReadBlock:
+        for (size_t i = 0; i < access->count; ++i) {
+            SDMRegisterAccessEx word = *access;
+            word.value = &value[i];
+            if ((access->flags & SDMRegisterAccessFlag_Gated) != 0) {
+                uint32_t gateValue = (uint32_t)access->gateValue;
+                SDMRegisterAccessEx gate = *access;
+                gate.op = SDMRegisterAccessOp_Poll;
+                gate.address = access->gateAddress;
+                gate.value = &gateValue;
+                SDMReturnCode result = performRegisterAccess(link, isMailbox, &gate);
+                if (result != SDMReturnCode_Success) {
+                    return result;
+                }
+            }
+            word.op = access->op == SDMRegisterAccessOp_WriteBlock ? SDMRegisterAccessOp_Write : SDMRegisterAccessOp_Read;
+            SDMReturnCode result = performRegisterAccess(link, isMailbox, &word);
+            if (result != SDMReturnCode_Success) {
+                return result;
+            }
+        }
+        return SDMReturnCode_Success;
+
+    case SDMRegisterAccessOp_Poll:
+    {
+        // Polling runs in the probe, so only the elapsed time is charged, once the poll has finished.
+        uint64_t interval = link->config.pollIntervalNs != 0 ? link->config.pollIntervalNs : 1;
+        if ((uint64_t)access->pollIntervalUs * 1000u > interval) {
+            interval = (uint64_t)access->pollIntervalUs * 1000u;
+        }
+        const size_t limit = access->retries != 0 ? access->retries : SIM_POLL_READ_LIMIT;
+        const uint64_t timeout = access->pollTimeoutUs != 0 ? access->pollTimeoutUs * 1000u : UINT64_MAX;
+        SDMReturnCode result = SDMReturnCode_TimeoutError;
+        uint64_t elapsed = 0;
+        for (size_t i = 0; i < limit; ++i) {
+            uint32_t status = 0;
+            if (isMailbox && access->address == link->config.mailboxStatusOffset) {
+                status = mailboxStatus(link, link->nowNs + elapsed);
+            }
+            link->counters.pollReads++;
+            if ((status & access->pollMask) == *value) {
+                result = SDMReturnCode_Success;
+                break;
+            }
+            if (elapsed + interval > timeout) {
+                elapsed = timeout;
+                break;
+            }
+            elapsed += interval;
+        }
+        advance(link, elapsed);
+        return result;
+    }
+
+    default:
+        return SDMReturnCode_InvalidArgument;
+    }
+}
+
+// Check the device and transfer size shared by all accesses of a register access callback.
+static SDMReturnCode checkRegisterDevice(
+    SimLink *link,
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    SDMBool *isMailbox)
+{
+    if (device == NULL || device->deviceType != SDMDeviceType_ArmADI_AP) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    if (transferSize != SDMTransferSize_32) {
+        return SDMReturnCode_UnsupportedTransferSize;
+    }
+    if (device->armAP.address != link->config.mailboxApIndex
+            && device->armAP.address != link->config.memApIndex) {
+        return SDMReturnCode_TransferFault;
+    }
+    *isMailbox = device->armAP.address == link->config.mailboxApIndex;
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode registerAccess(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    SDMBool isMailbox = false;
+    size_t completed = 0;
+
+    // The whole sequence is one probe transaction; the payload is charged per access as it is performed.
+    transaction(link, SDMCallbackId_RegisterAccess, 0, 0);
+
+    SDMReturnCode result = checkRegisterDevice(link, device, transferSize, &isMailbox);
+    for (; result == SDMReturnCode_Success && completed < accessCount; ++completed) {
+        // The block operations are only valid for registerAccessEx.
+        if (accesses[completed].op > SDMRegisterAccessOp_Poll) {
+            result = SDMReturnCode_InvalidArgument;
+            break;
+        }
+        const SDMRegisterAccessEx access = {
+            .address = accesses[completed].address,
+            .op = accesses[completed].op,
+            .pollMask = accesses[completed].pollMask,
+            .value = accesses[completed].value,
+            .retries = accesses[completed].retries,
+        };
+        result = performRegisterAccess(link, isMailbox, &access);
+        if (result != SDMReturnCode_Success) {
+            break;
+        }
+    }
+
+    if (accessesCompleted != NULL) {
+        *accessesCompleted = completed;
+    }
+    return groupCall(link, result);
+}
+
+static SDMReturnCode registerAccessEx(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccessEx *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    SDMBool isMailbox = false;
+    size_t completed = 0;
+
+    transaction(link, SDMCallbackId_RegisterAccessEx, 0, 0);
+
+    SDMReturnCode result = checkRegisterDevice(link, device, transferSize, &isMailbox);
+    for (; result == SDMReturnCode_Success && completed < accessCount; ++completed) {
+        result = performRegisterAccess(link, isMailbox, &accesses[completed]);
+        if (result != SDMReturnCode_Success) {
+            break;
+        }
+    }
+
+    if (accessesCompleted != NULL) {
+        *accessesCompleted = completed;
+    }
+    return groupCall(link, result);
+}
+
+static SDMReturnCode presentForm(const SDMForm *form, void *refcon)
+{
+    // Accept the form's initial values.
+    (void)form;
+    ((SimLink *)refcon)->counters.callbackCount[SDMCallbackId_PresentForm]++;
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode transferMemoryBatch(
+    const SDMMemoryAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    SDMReturnCode result = SDMReturnCode_Success;
+    size_t completed = 0;
+
+    transaction(link, SDMCallbackId_TransferMemoryBatch, 0, 0);
+
+    for (; completed < accessCount; ++completed) {
+        const SDMMemoryAccess *access = &accesses[completed];
+        uint8_t *ptr = NULL;
+        uint64_t length = 0;
+        result = resolveMemory(link, access->device, access->address, access->transferSize,
+                access->transferCount, &ptr, &length);
+        if (result == SDMReturnCode_Success && access->data == NULL) {
+            result = SDMReturnCode_InvalidArgument;
+        }
+        if (result != SDMReturnCode_Success) {
+            break;
+        }
+        if (access->direction == SDMTransferDirection_Read) {
+            memcpy(access->data, ptr, (size_t)length);
+            payload(link, length, 0);
+        }
+        else if (access->direction == SDMTransferDirection_Write) {
+            memcpy(ptr, access->data, (size_t)length);
+            invalidateRange(link, (uint64_t)(ptr - link->memory), length);
+            payload(link, 0, length);
+        }
+        else {
+            result = SDMReturnCode_InvalidArgument;
+            break;
+        }
+    }
+
+    if (accessesCompleted != NULL) {
+        *accessesCompleted = completed;
+    }
+    return groupCall(link, result);
+}
+
+static SDMReturnCode acquireTransferBuffer(size_t size, void **buffer, void *refcon)
+{
+    ((SimLink *)refcon)->counters.callbackCount[SDMCallbackId_AcquireTransferBuffer]++;
+    if (buffer == NULL || size == 0) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    // malloc() alignment is sufficient for the advertised SIM_TRANSFER_BUFFER_ALIGNMENT.
+    *buffer = malloc(size);
+    return *buffer != NULL ? SDMReturnCode_Success : SDMReturnCode_RequestFailed;
+}
+
+static void releaseTransferBuffer(void *buffer, void *refcon)
+{
+    ((SimLink *)refcon)->counters.callbackCount[SDMCallbackId_ReleaseTransferBuffer]++;
+    free(buffer);
+}
+
+static SDMBool formCacheKey(char *key, const char *formId, const char *elementId)
+{
+    int length = snprintf(key, SIM_FORM_VALUE_LENGTH, "%s.%s", formId, elementId);
+    return length > 0 && length < SIM_FORM_VALUE_LENGTH;
+}
+
+static SDMReturnCode loadFormValue(
+    const char *formId,
+    const char *elementId,
+    char *buffer,
+    size_t bufferLength,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    char key[SIM_FORM_VALUE_LENGTH];
+
+    link->counters.callbackCount[SDMCallbackId_LoadFormValue]++;
+    if (formId == NULL || elementId == NULL || buffer == NULL || !formCacheKey(key, formId, elementId)) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    for (size_t i = 0; i < link->formCacheCount; ++i) {
+        if (strcmp(link->formCache[i].key, key) == 0) {
+            size_t length = strlen(link->formCache[i].value);
+            if (length >= bufferLength) {
+                return SDMReturnCode_InvalidArgument;
+            }
+            memcpy(buffer, link->formCache[i].value, length + 1);
+            return SDMReturnCode_Success;
+        }
+    }
+    return SDMReturnCode_RequestFailed;
+}
+
+static SDMReturnCode storeFormValue(const char *formId, const char *elementId, const char *value, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    char key[SIM_FORM_VALUE_LENGTH];
+    size_t i;
+
+    link->counters.callbackCount[SDMCallbackId_StoreFormValue]++;
+    if (formId == NULL || elementId == NULL || value == NULL || !formCacheKey(key, formId, elementId)) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    if (strlen(value) >= SIM_FORM_VALUE_LENGTH) {
+        // Decline values that do not fit, as a host without storage for them would.
+        return SDMReturnCode_Success;
+    }
+    for (i = 0; i < link->formCacheCount; ++i) {
+        if (strcmp(link->formCache[i].key, key) == 0) {
+            break;
+        }
+    }
+    if (i == link->formCacheCount) {
+        if (link->formCacheCount == SIM_FORM_CACHE_ENTRIES) {
+            return SDMReturnCode_RequestFailed;
+        }
+        strcpy(link->formCache[i].key, key);
+        link->formCacheCount++;
+    }
+    strcpy(link->formCache[i].value, value);
+    return SDMReturnCode_Success;
+}
+
+static void endPhase(SimLink *link, uint64_t timestampNs)
+{
+    if (link->currentPhase < SDMStatistics_MaxPhases) {
+        // In real-time mode the event timestamps already include the modelled link time.
+        uint64_t elapsed = timestampNs - link->phaseStartNs;
+        if (!link->config.realTime) {
+            elapsed += link->nowNs - link->phaseStartLinkNs;
+        }
+        link->counters.phaseNs[link->currentPhase] += elapsed;
+        link->currentPhase = SDMStatistics_MaxPhases;
+    }
+}
+
+static void reportProgressEvent(const SDMProgressEvent *event, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+
+    link->counters.callbackCount[SDMCallbackId_ReportProgressEvent]++;
+    if (event == NULL || event->phase >= SDMStatistics_MaxPhases) {
+        return;
+    }
+    switch (event->type) {
+    case SDMProgressEvent_PhaseBegin:
+        // A begin event implicitly ends the previous phase.
+        endPhase(link, event->timestampNs);
+        link->currentPhase = event->phase;
+        link->phaseStartNs = event->timestampNs;
+        link->phaseStartLinkNs = link->nowNs;
+        break;
+    case SDMProgressEvent_PhaseEnd:
+        if (event->phase == link->currentPhase) {
+            endPhase(link, event->timestampNs);
+        }
+        link->counters.phaseBytes[event->phase] += event->bytesSent + event->bytesReceived;
+        break;
+    default:
+        break;
+    }
+}
+
+static SDMReturnCode declareMemoryRegion(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    uint64_t size,
+    uint32_t attributes,
+    SDMMemoryRegionKind kind,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    uint8_t *ptr = NULL;
+    uint64_t length = 0;
+    (void)attributes;
+
+    link->counters.callbackCount[SDMCallbackId_DeclareMemoryRegion]++;
+    if (size == 0 || size > SIZE_MAX || (kind != SDMMemoryRegion_Immutable && kind != SDMMemoryRegion_Volatile)) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    if (link->cacheable == NULL) {
+        return SDMReturnCode_Success;
+    }
+    // Regions outside simulated RAM are never cached, so declarations for them are accepted and ignored.
+    if (resolveMemory(link, device, address, SDMTransferSize_8, (size_t)size, &ptr, &length) != SDMReturnCode_Success) {
+        return SDMReturnCode_Success;
+    }
+    const uint64_t offset = (uint64_t)(ptr - link->memory);
+    memset(link->cacheable + offset, kind == SDMMemoryRegion_Immutable, (size_t)length);
+    if (kind == SDMMemoryRegion_Volatile) {
+        invalidateRange(link, offset, length);
+    }
+    return SDMReturnCode_Success;
+}
+
+static void invalidateMemoryCache(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    uint8_t *ptr = NULL;
+    uint64_t length = 0;
+
+    link->counters.callbackCount[SDMCallbackId_InvalidateMemoryCache]++;
+    if (device == NULL || size == 0) {
+        invalidateAll(link);
+    }
+    else if (size <= SIZE_MAX && link->cached != NULL
+            && resolveMemory(link, device, address, SDMTransferSize_8, (size_t)size, &ptr, &length) == SDMReturnCode_Success) {
+        invalidateRange(link, (uint64_t)(ptr - link->memory), length);
+    }
+}
+
+// Streamed chunks are pipelined by the simulated probe: each chunk costs only its bandwidth, and the stream pays
+// one transaction latency when it is closed, for draining the queue.
+static SDMReturnCode openWriteStream(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    uint32_t attributes,
+    uint64_t totalSize,
+    SDMWriteStream *stream,
+    void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    uint8_t *ptr = NULL;
+    uint64_t length = 0;
+    (void)attributes;
+    (void)totalSize;
+
+    link->counters.callbackCount[SDMCallbackId_OpenWriteStream]++;
+    if (stream == NULL) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    SDMReturnCode result = resolveMemory(link, device, address, transferSize, 0, &ptr, &length);
+    if (result != SDMReturnCode_Success) {
+        return result;
+    }
+    for (size_t i = 0; i < SIM_MAX_WRITE_STREAMS; ++i) {
+        struct SimWriteStream *slot = &link->writeStreams[i];
+        if (!slot->open) {
+            memset(slot, 0, sizeof(*slot));
+            slot->open = true;
+            slot->offset = (uint64_t)(ptr - link->memory);
+            slot->unit = transferSize / 8;
+            slot->error = SDMReturnCode_Success;
+            *stream = (SDMWriteStream)slot;
+            return SDMReturnCode_Success;
+        }
+    }
+    return SDMReturnCode_RequestFailed;
+}
+
+static SDMReturnCode writeStreamChunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    struct SimWriteStream *slot = (struct SimWriteStream *)stream;
+    (void)flags;
+
+    link->counters.callbackCount[SDMCallbackId_WriteStreamChunk]++;
+    if (slot == NULL || !slot->open || data == NULL || (size % slot->unit) != 0) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    if (slot->error != SDMReturnCode_Success) {
+        return slot->error;
+    }
+    // The chunk completes at once, so the queue is never full and SDMWriteChunk_NoWait has no effect.
+    if (size > link->config.memorySize - slot->offset) {
+        slot->error = SDMReturnCode_TransferFault;
+        return slot->error;
+    }
+    memcpy(link->memory + slot->offset, data, size);
+    invalidateRange(link, slot->offset, size);
+    payload(link, 0, size);
+    slot->offset += size;
+    slot->written += size;
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode closeWriteStream(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    struct SimWriteStream *slot = (struct SimWriteStream *)stream;
+    (void)abort;
+
+    if (slot == NULL || !slot->open) {
+        link->counters.callbackCount[SDMCallbackId_CloseWriteStream]++;
+        return SDMReturnCode_InvalidArgument;
+    }
+    transaction(link, SDMCallbackId_CloseWriteStream, 0, 0);
+    if (bytesWritten != NULL) {
+        *bytesWritten = slot->written;
+    }
+    slot->open = false;
+    return slot->error;
+}
+
+static SDMReturnCode beginTransactionGroup(uint32_t flags, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+    (void)flags;
+
+    link->counters.callbackCount[SDMCallbackId_BeginTransactionGroup]++;
+    if (link->groupActive) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    link->groupActive = true;
+    link->groupCalls = 0;
+    link->groupError = SDMReturnCode_Success;
+    return SDMReturnCode_Success;
+}
+
+static SDMReturnCode commitTransactionGroup(size_t *callsCompleted, void *refcon)
+{
+    SimLink *link = (SimLink *)refcon;
+
+    if (!link->groupActive) {
+        link->counters.callbackCount[SDMCallbackId_CommitTransactionGroup]++;
+        return SDMReturnCode_InvalidArgument;
+    }
+    link->groupActive = false;
+    transaction(link, SDMCallbackId_CommitTransactionGroup, 0, 0);
+    // Accesses were performed, and their errors returned, at call time. The commit reports them again.
+    if (callsCompleted != NULL) {
+        *callsCompleted = link->groupCalls;
+    }
+    return link->groupError;
+}
+
+void simLinkDefaultConfig(SimLinkConfig *config)
+{
+    memset(config, 0, sizeof(*config));
+    config->transactionLatencyNs = 1000000;     // 1 ms, typical of a USB probe.
+    config->bytesPerSecond = 1000000;
+    config->pollIntervalNs = 1000;
+    config->responseDelayNs = 100000;
+    config->resetNs = 10000000;
+    config->memoryBase = 0x20000000;
+    config->memorySize = 256 * 1024;
+    config->memApIndex = 0;
+    config->mailboxApIndex = 1;
+    config->mailboxDataOffset = 0xD30;
+    config->mailboxStatusOffset = 0xD2C;
+    config->realTime = false;
+}
+
+SDMReturnCode simLinkInit(SimLink *link, const SimLinkConfig *config)
+{
+    memset(link, 0, sizeof(*link));
+    link->config = *config;
+    link->memory = (uint8_t *)calloc(1, config->memorySize != 0 ? config->memorySize : 1);
+    if (link->memory == NULL) {
+        return SDMReturnCode_InternalError;
+    }
+    link->responder = echoResponder;
+    link->cacheEmpty = true;
+    if (config->readCache) {
+        link->cacheable = (uint8_t *)calloc(1, config->memorySize != 0 ? config->memorySize : 1);
+        link->cached = (uint8_t *)calloc(1, config->memorySize != 0 ? config->memorySize : 1);
+        if (link->cacheable == NULL || link->cached == NULL) {
+            simLinkDestroy(link);
+            return SDMReturnCode_InternalError;
+        }
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        link->components[i].device.deviceType = SDMDeviceType_ArmADI_AP;
+        link->components[i].device.armAP.address = i == 0 ? config->memApIndex : config->mailboxApIndex;
+        link->components[i].apIdr = i == 0 ? SIM_MEM_AP_IDR : SIM_MAILBOX_AP_IDR;
+    }
+    link->topology.flags = SDMTopology_Complete;
+    link->topology.components = link->components;
+    link->topology.componentCount = 2;
+
+    link->capabilities.flags = SDMHostCapability_ProbePolling;
+    if (config->overlappedReset) {
+        link->capabilities.flags |= SDMHostCapability_OverlappedReset;
+    }
+    if (config->readCache) {
+        link->capabilities.flags |= SDMHostCapability_ReadCache;
+    }
+    link->capabilities.flags |= SDMHostCapability_TransactionGroups;
+    link->capabilities.minPollIntervalUs = (uint32_t)((config->pollIntervalNs + 999) / 1000);
+    link->capabilities.registerTransferSizes = SDMTransferSizeMask_32;
+    link->capabilities.transferBufferAlignment = SIM_TRANSFER_BUFFER_ALIGNMENT;
+    link->capabilities.preferredWriteChunkSize = SIM_WRITE_CHUNK_SIZE;
+    link->capabilities.writeStreamQueueDepth = SIM_WRITE_QUEUE_DEPTH;
+    link->capabilities.maxTransferBufferSize = config->memorySize;
+
+    link->callbacks.updateProgress = updateProgress;
+    link->callbacks.setErrorMessage = setErrorMessage;
+    link->callbacks.resetStart = resetStart;
+    link->callbacks.resetFinish = resetFinish;
+    link->callbacks.readMemory = readMemory;
+    link->callbacks.writeMemory = writeMemory;
+    link->callbacks.registerAccess = registerAccess;
+    link->callbacks.presentForm = presentForm;
+    link->callbacks.transferMemoryBatch = transferMemoryBatch;
+    link->callbacks.registerAccessEx = registerAccessEx;
+    link->callbacks.acquireTransferBuffer = acquireTransferBuffer;
+    link->callbacks.releaseTransferBuffer = releaseTransferBuffer;
+    link->callbacks.loadFormValue = loadFormValue;
+    link->callbacks.storeFormValue = storeFormValue;
+    link->callbacks.reportProgressEvent = reportProgressEvent;
+    link->callbacks.declareMemoryRegion = declareMemoryRegion;
+    link->callbacks.invalidateMemoryCache = invalidateMemoryCache;
+    link->callbacks.openWriteStream = openWriteStream;
+    link->callbacks.writeStreamChunk = writeStreamChunk;
+    link->callbacks.closeWriteStream = closeWriteStream;
+    link->callbacks.beginTransactionGroup = beginTransactionGroup;
+    link->callbacks.commitTransactionGroup = commitTransactionGroup;
+    link->currentPhase = SDMStatistics_MaxPhases;
+    return SDMReturnCode_Success;
+}
+
+void simLinkDestroy(SimLink *link)
+{
+    free(link->memory);
+    free(link->cacheable);
+    free(link->cached);
+    link->memory = NULL;
+    link->cacheable = NULL;
+    link->cached = NULL;
+}
+
+void simLinkSetResponder(SimLink *link, SimMailboxResponder responder, void *context)
+{
+    link->responder = responder;
+    link->responderContext = context;
+}
+
+void simLinkMailboxPost(SimLink *link, uint32_t word)
+{
+    if (link->rxCount == SIM_MAILBOX_FIFO_WORDS) {
+        link->counters.mailboxOverflows++;
+        return;
+    }
+    const size_t tail = (link->rxHead + link->rxCount) % SIM_MAILBOX_FIFO_WORDS;
+    link->rxFifo[tail].word = word;
+    link->rxFifo[tail].readyNs = link->nowNs + link->config.responseDelayNs;
+    link->rxCount++;
+}
+
+void simLinkResetCounters(SimLink *link)
+{
+    memset(&link->counters, 0, sizeof(link->counters));
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @file
+ *
+ * @brief Simulated debug link used by the SDM benchmark harness.
+ *
+ * The simulated link implements #SDMCallbacks for an Arm ADI target with one MEM-AP, backed by a flat RAM
+ * region, and one mailbox AP. The mailbox is a simplified model of an SDC-600 COM-AP: a 32-bit data register
+ * and a status register with TX-ready and RX-ready bits. It is not cycle accurate. The target side of the
+ * mailbox is provided by a responder hook.
+ *
+ * Link cost is modelled with a virtual clock. Each probe transaction, which is one callback invocation, costs
+ * a fixed latency plus the time to move its payload at the configured bandwidth. Poll loops run in the
+ * simulated probe, as advertised by #SDMHostCapability_ProbePolling. Optionally, the link sleeps for the
+ * modelled time so that wall-clock measurements include it.
+ *
+ * Accesses within a transaction group are performed at call time, but only the commit is charged the
+ * transaction latency, as if the probe had received the group as one command list.
+ */
+
+#ifndef _SIM_LINK_H_
+#define _SIM_LINK_H_
+
+#include "secure_debug_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Mailbox status register bits.
+ */
+enum SimMailboxStatusEnum {
+    SimMailboxStatus_TxReady = (1 << 0),    //!< The data register can be written.
+    SimMailboxStatus_RxReady = (1 << 1),    //!< The data register holds a word from the target.
+};
+
+/*!
+ * @brief Configuration of the simulated link.
+ */
+typedef struct SimLinkConfig {
+    uint64_t transactionLatencyNs;  //!< Fixed cost of each probe transaction.
+    uint64_t bytesPerSecond;        //!< Link bandwidth. Zero means unlimited.
+    uint64_t pollIntervalNs;        //!< Time for one poll read performed by the probe.
+    uint64_t responseDelayNs;       //!< Delay before a word posted by the responder can be read.
+    uint64_t resetNs;               //!< Duration of a target reset.
+    uint64_t memoryBase;            //!< Base address of RAM behind the MEM-AP.
+    size_t memorySize;              //!< Size in bytes of RAM behind the MEM-AP.
+    uint8_t memApIndex;             //!< AP index of the MEM-AP.
+    uint8_t mailboxApIndex;         //!< AP index of the mailbox AP.
+    uint32_t mailboxDataOffset;     //!< Mailbox data register offset.
+    uint32_t mailboxStatusOffset;   //!< Mailbox status register offset.
+    SDMBool realTime;               //!< If true, sleep for the modelled link time.
+    SDMBool overlappedReset;        //!< If true, advertise #SDMHostCapability_OverlappedReset.
+    SDMBool readCache;              //!< If true, cache reads of immutable regions and advertise #SDMHostCapability_ReadCache.
+} SimLinkConfig;
+
+/*!
+ * @brief Counters of simulated link traffic.
+ */
+typedef struct SimLinkCounters {
+    uint64_t transactions;                                  //!< Probe transactions.
+    uint64_t callbackCount[SDMStatistics_MaxCallbacks];     //!< Callback invocations, indexed by #SDMCallbackIdEnum.
+    uint64_t bytesRead;                                     //!< Payload bytes read.
+    uint64_t bytesWritten;                                  //!< Payload bytes written.
+    uint64_t pollReads;                                     //!< Poll reads performed by the probe.
+    uint64_t mailboxUnderflows;                             //!< Reads of the data register with no word ready.
+    uint64_t mailboxOverflows;                              //!< Words dropped because the RX FIFO was full.
+    uint64_t readCacheHits;                                 //!< Memory reads satisfied from the read cache.
+    uint64_t resetOverlapNs;                                //!< Reset time hidden by SDM work between the reset callbacks.
+    uint64_t groupedCalls;                                  //!< Callbacks made within transaction groups.
+    uint64_t phaseNs[SDMStatistics_MaxPhases];              //!< Phase durations from progress events, including modelled link time.
+    uint64_t phaseBytes[SDMStatistics_MaxPhases];           //!< Message bytes sent and received per phase, from progress events.
+} SimLinkCounters;
+
+struct SimLink;
+
+/*!
+ * @brief Target side of the mailbox.
+ *
+ * Called for each word the SDM writes to the mailbox data register. The responder replies by calling
+ * simLinkMailboxPost().
+ */
+typedef void (*SimMailboxResponder)(struct SimLink *link, uint32_t word, void *context);
+
+//! @brief Capacity of the mailbox RX FIFO, in words.
+#define SIM_MAILBOX_FIFO_WORDS 4096
+
+//! @brief Maximum number of open write streams.
+#define SIM_MAX_WRITE_STREAMS 4
+
+//! @brief Capacity of the form value cache, in values.
+#define SIM_FORM_CACHE_ENTRIES 16
+
+//! @brief Maximum length of a cached form value or key, including the terminating null.
+#define SIM_FORM_VALUE_LENGTH 256
+
+/*!
+ * @brief Simulated link state.
+ */
+typedef struct SimLink {
+    SimLinkConfig config;           //!< Link configuration.
+    SDMCallbacks callbacks;         //!< Callback table; pass with this link as the refcon.
+    SDMHostCapabilities capabilities; //!< Capabilities of the simulated host and probe.
+    SDMComponentInfo components[2]; //!< The MEM-AP and the mailbox AP.
+    SDMTopology topology;           //!< Complete topology of the simulated target, listing _components_.
+    SimLinkCounters counters;       //!< Traffic counters.
+    uint64_t nowNs;                 //!< Virtual clock.
+    uint8_t *memory;                //!< RAM contents.
+    uint8_t *cacheable;             //!< Per RAM byte, non-zero if it lies in a region declared immutable.
+    uint8_t *cached;                //!< Per RAM byte, non-zero if it is held in the read cache.
+    SDMBool cacheEmpty;             //!< True if no byte is held in the read cache.
+    struct SimWriteStream {
+        SDMBool open;               //!< True if the stream is open.
+        uint64_t offset;            //!< RAM offset of the next byte to write.
+        uint64_t unit;              //!< Transfer size in bytes.
+        uint64_t written;           //!< Payload bytes written.
+        SDMReturnCode error;        //!< First error of the stream.
+    } writeStreams[SIM_MAX_WRITE_STREAMS]; //!< Write streams; an SDMWriteStream points to an element.
+    SimMailboxResponder responder;  //!< Mailbox responder hook.
+    void *responderContext;         //!< Context passed to the responder.
+    struct {
+        uint32_t word;              //!< Data word.
+        uint64_t readyNs;           //!< Virtual time at which the word can be read.
+    } rxFifo[SIM_MAILBOX_FIFO_WORDS]; //!< Mailbox RX FIFO ring.
+    size_t rxHead;                  //!< Index of the oldest RX word.
+    size_t rxCount;                 //!< Number of RX words.
+    struct {
+        char key[SIM_FORM_VALUE_LENGTH];    //!< Form ID and element ID, separated by a '.'.
+        char value[SIM_FORM_VALUE_LENGTH];  //!< Cached value.
+    } formCache[SIM_FORM_CACHE_ENTRIES]; //!< Form value cache. Persists across SDM instances using the link.
+    size_t formCacheCount;          //!< Number of cached form values.
+    SDMPhase currentPhase;          //!< Phase of the last begin event, or SDMStatistics_MaxPhases if none.
+    uint64_t phaseStartNs;          //!< Event timestamp of the current phase's begin event.
+    uint64_t phaseStartLinkNs;      //!< Virtual clock at the current phase's begin event.
+    uint64_t resetStartWallNs;      //!< Wall-clock time of the last overlapped resetStart.
+    uint64_t resetStartLinkNs;      //!< Virtual clock at the last overlapped resetStart.
+    SDMBool groupActive;            //!< True between beginTransactionGroup and commitTransactionGroup.
+    size_t groupCalls;              //!< Calls of the open transaction group that completed before its first failure.
+    SDMReturnCode groupError;       //!< First failure in the open transaction group.
+} SimLink;
+
+//! @brief Fill in a configuration with default values.
+void simLinkDefaultConfig(SimLinkConfig *config);
+
+/*!
+ * @brief Initialise a simulated link.
+ *
+ * The default responder echoes each word back to the SDM.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InternalError RAM could not be allocated.
+ */
+SDMReturnCode simLinkInit(SimLink *link, const SimLinkConfig *config);
+
+//! @brief Release resources held by a simulated link.
+void simLinkDestroy(SimLink *link);
+
+//! @brief Replace the mailbox responder.
+void simLinkSetResponder(SimLink *link, SimMailboxResponder responder, void *context);
+
+//! @brief Post a word from the target into the mailbox RX FIFO.
+void simLinkMailboxPost(SimLink *link, uint32_t word);
+
+//! @brief Clear the traffic counters.
+void simLinkResetCounters(SimLink *link);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SIM_LINK_H_ */
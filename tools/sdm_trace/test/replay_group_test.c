@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Replay of a trace that diverges within a transaction group.
+ *
+ * Records a group of two writes and a read against the simulated link, then replays it with a different second
+ * write. The replay must begin the group on the mock link when it diverges, so that the forwarded calls are
+ * grouped and the forwarded commit succeeds and counts every call of the group.
+ *
+ * Usage: replay_group_test [trace-path]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sim_link.h"
+#include "trace_recorder.h"
+#include "trace_replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned failures;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+// Issue the group as an SDM would, writing _second_ as the second word.
+static SDMReturnCode runGroup(const SDMCallbacks *callbacks, void *refcon, const SDMDeviceDescriptor *device,
+    uint64_t base, uint32_t second, size_t *callsCompleted)
+{
+    const uint32_t first = 0x11111111;
+    uint32_t read = 0;
+    SDMReturnCode result = callbacks->beginTransactionGroup(0, refcon);
+    if (result != SDMReturnCode_Success) {
+        return result;
+    }
+    callbacks->writeMemory(device, base, SDMTransferSize_32, 1, 0, &first, refcon);
+    callbacks->writeMemory(device, base + 4, SDMTransferSize_32, 1, 0, &second, refcon);
+    callbacks->readMemory(device, base, SDMTransferSize_32, 1, 0, &read, refcon);
+    return callbacks->commitTransactionGroup(callsCompleted, refcon);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "replay_group_test.sdmtrace";
+    SimLinkConfig config;
+    simLinkDefaultConfig(&config);
+    SDMDeviceDescriptor device;
+    memset(&device, 0, sizeof(device));
+    device.deviceType = SDMDeviceType_ArmADI_AP;
+    device.armAP.address = config.memApIndex;
+
+    SimLink *link = (SimLink *)malloc(sizeof(SimLink));
+    if (link == NULL || simLinkInit(link, &config) != SDMReturnCode_Success) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+    SDMOpenParameters params;
+    memset(&params, 0, sizeof(params));
+    params.version.major = 1;
+    params.version.minor = 1;
+    params.callbacks = &link->callbacks;
+    params.refcon = link;
+
+    // Record.
+    TraceRecorder recorder;
+    size_t completed = 0;
+    CHECK(traceRecorderInit(&recorder, path, &params, NULL, NULL) == SDMReturnCode_Success);
+    CHECK(runGroup(&recorder.callbacks, &recorder, &device, config.memoryBase, 0x22222222, &completed)
+        == SDMReturnCode_Success);
+    CHECK(completed == 3);
+    CHECK(traceRecorderFinish(&recorder) == SDMReturnCode_Success);
+
+    // Replay with a different second write, against a fresh link.
+    simLinkDestroy(link);
+    if (simLinkInit(link, &config) != SDMReturnCode_Success) {
+        fprintf(stderr, "error: out of memory\n");
+        return 1;
+    }
+    TraceReplay replay;
+    completed = 0;
+    CHECK(traceReplayInit(&replay, path, &link->callbacks, link) == SDMReturnCode_Success);
+    CHECK(runGroup(&replay.callbacks, &replay, &device, config.memoryBase, 0x33333333, &completed)
+        == SDMReturnCode_Success);
+    CHECK(replay.diverged && !replay.exhausted);
+    CHECK(replay.divergedCallback == SDMCallbackId_WriteMemory);
+    CHECK(replay.served == 2);
+    CHECK(replay.forwarded == 3);
+    CHECK(completed == 3);
+    CHECK(link->counters.callbackCount[SDMCallbackId_BeginTransactionGroup] == 1);
+    CHECK(link->counters.groupedCalls == 2);
+    CHECK(!link->groupActive);
+    traceReplayDestroy(&replay);
+
+    simLinkDestroy(link);
+    free(link);
+    remove(path);
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1017 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace_recorder.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t monotonicNs(void *context)
+{
+    (void)context;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+static size_t elementSize(SDMTransferSize transferSize)
+{
+    return transferSize / 8u;
+}
+
+//! @name Record encoding
+//!
+//! Records are encoded into the pending buffer by offset, since appending may move the buffer. Allocation
+//! failures are latched in the recorder's error and the record is dropped when it is written.
+//@{
+
+// Reserve zeroed space at the end of the pending buffer and return its offset.
+static size_t reserve(TraceRecorder *recorder, size_t size)
+{
+    const size_t offset = recorder->pendingSize;
+    if (recorder->pendingSize + size > recorder->pendingCapacity) {
+        size_t capacity = recorder->pendingCapacity != 0 ? recorder->pendingCapacity : 4096;
+        while (capacity < recorder->pendingSize + size) {
+            capacity *= 2;
+        }
+        uint8_t *pending = (uint8_t *)realloc(recorder->pending, capacity);
+        if (pending == NULL) {
+            recorder->error = SDMReturnCode_InternalError;
+            return offset;
+        }
+        recorder->pending = pending;
+        recorder->pendingCapacity = capacity;
+    }
+    memset(recorder->pending + offset, 0, size);
+    recorder->pendingSize += size;
+    return offset;
+}
+
+static size_t appendCopy(TraceRecorder *recorder, const void *data, size_t size)
+{
+    const size_t offset = reserve(recorder, size);
+    if (recorder->error == SDMReturnCode_Success && size != 0) {
+        memcpy(recorder->pending + offset, data, size);
+    }
+    return offset;
+}
+
+static void addFixup(TraceRecorder *recorder, size_t offset, const void *source, size_t size, SDMBool count,
+    void *owned)
+{
+    if (recorder->fixupCount == recorder->fixupCapacity) {
+        const size_t capacity = recorder->fixupCapacity != 0 ? recorder->fixupCapacity * 2 : 64;
+        struct TraceFixup *fixups = (struct TraceFixup *)realloc(recorder->fixups, capacity * sizeof(*fixups));
+        if (fixups == NULL) {
+            recorder->error = SDMReturnCode_InternalError;
+            free(owned);
+            return;
+        }
+        recorder->fixups = fixups;
+        recorder->fixupCapacity = capacity;
+    }
+    recorder->fixups[recorder->fixupCount].offset = offset;
+    recorder->fixups[recorder->fixupCount].source = source;
+    recorder->fixups[recorder->fixupCount].size = size;
+    recorder->fixups[recorder->fixupCount].count = count;
+    recorder->fixups[recorder->fixupCount].owned = owned;
+    recorder->fixupCount++;
+}
+
+// Reserve space for SDM data that is only valid once the pending records are written, such as read data
+// within a transaction group.
+static void appendDeferred(TraceRecorder *recorder, const void *data, size_t size)
+{
+    const size_t offset = reserve(recorder, size);
+    if (recorder->error != SDMReturnCode_Success || size == 0) {
+        return;
+    }
+    addFixup(recorder, offset, data, size, false, NULL);
+}
+
+// Provide the accessesCompleted argument to pass to the host. The SDM's own pointer is forwarded; if it passed
+// NULL, the count goes to _local_ outside a transaction group, or to a recorder-owned slot within one, since the
+// host may write it as late as the commit. Returns NULL if a slot could not be allocated.
+static size_t *completedSlot(TraceRecorder *recorder, size_t *accessesCompleted, size_t *local)
+{
+    if (accessesCompleted != NULL) {
+        return accessesCompleted;
+    }
+    *local = 0;
+    if (!recorder->groupActive) {
+        return local;
+    }
+    size_t *slot = (size_t *)calloc(1, sizeof(*slot));
+    if (slot == NULL) {
+        recorder->error = SDMReturnCode_InternalError;
+    }
+    return slot;
+}
+
+// Fill the accessesCompleted field at _offset_ from _completed_ when the pending records are written. Takes
+// ownership of _completed_ if it is not the SDM's pointer or a stack slot.
+static void deferCompleted(TraceRecorder *recorder, size_t offset, const size_t *completed,
+    const size_t *accessesCompleted, const size_t *local)
+{
+    void *owned = completed != accessesCompleted && completed != local ? (void *)completed : NULL;
+    if (recorder->error != SDMReturnCode_Success || completed == NULL) {
+        free(owned);
+        return;
+    }
+    addFixup(recorder, offset, completed, sizeof(uint64_t), true, owned);
+}
+
+// Start a record. Takes the recorder lock, which flush() releases, since completion routines may record from
+// host threads.
+static size_t beginRecord(TraceRecorder *recorder, SDMCallbackId type, SDMReturnCode result, uint64_t startNs)
+{
+    pthread_mutex_lock(&recorder->lock);
+    const size_t offset = reserve(recorder, sizeof(SDMTraceRecordHeader));
+    if (recorder->error == SDMReturnCode_Success) {
+        SDMTraceRecordHeader *header = (SDMTraceRecordHeader *)(recorder->pending + offset);
+        header->type = (uint16_t)type;
+        header->flags = recorder->groupActive ? SDMTraceRecordFlag_Grouped : 0;
+        header->result = result;
+        header->timestampNs = startNs;
+        header->durationNs = traceRecorderNow(recorder) - startNs;
+    }
+    return offset;
+}
+
+static void endRecord(TraceRecorder *recorder, size_t offset)
+{
+    reserve(recorder, SDM_TRACE_ALIGN(recorder->pendingSize) - recorder->pendingSize);
+    if (recorder->error == SDMReturnCode_Success) {
+        SDMTraceRecordHeader *header = (SDMTraceRecordHeader *)(recorder->pending + offset);
+        header->size = (uint32_t)(recorder->pendingSize - offset);
+    }
+}
+
+// Write the pending records, unless a transaction group is open, and release the recorder lock.
+static void flush(TraceRecorder *recorder)
+{
+    if (recorder->groupActive) {
+        pthread_mutex_unlock(&recorder->lock);
+        return;
+    }
+    if (recorder->error == SDMReturnCode_Success) {
+        for (size_t i = 0; i < recorder->fixupCount; ++i) {
+            const struct TraceFixup *fixup = &recorder->fixups[i];
+            if (fixup->count) {
+                const uint64_t count = *(const size_t *)fixup->source;
+                memcpy(recorder->pending + fixup->offset, &count, sizeof(count));
+            }
+            else {
+                memcpy(recorder->pending + fixup->offset, fixup->source, fixup->size);
+            }
+        }
+        if (fwrite(recorder->pending, 1, recorder->pendingSize, recorder->file) != recorder->pendingSize) {
+            recorder->error = SDMReturnCode_RequestFailed;
+        }
+    }
+    for (size_t i = 0; i < recorder->fixupCount; ++i) {
+        free(recorder->fixups[i].owned);
+    }
+    recorder->pendingSize = 0;
+    recorder->fixupCount = 0;
+    pthread_mutex_unlock(&recorder->lock);
+}
+
+static void recordPlain(TraceRecorder *recorder, SDMCallbackId type, SDMReturnCode result, uint64_t startNs)
+{
+    endRecord(recorder, beginRecord(recorder, type, result, startNs));
+    recorder->records++;
+    flush(recorder);
+}
+
+static void recordMemory(
+    TraceRecorder *recorder,
+    SDMCallbackId type,
+    SDMReturnCode result,
+    uint64_t startNs,
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *data,
+    const SDMTraceAsyncRequest *async)
+{
+    const size_t offset = beginRecord(recorder, type, result, startNs);
+    if (async != NULL) {
+        appendCopy(recorder, async, sizeof(*async));
+    }
+    SDMTraceMemory payload;
+    memset(&payload, 0, sizeof(payload));
+    SDMTraceEncodeDevice(device, &payload.device);
+    payload.address = address;
+    payload.transferSize = transferSize;
+    payload.attributes = attributes;
+    payload.transferCount = transferCount;
+    appendCopy(recorder, &payload, sizeof(payload));
+    if (type == SDMCallbackId_ReadMemory) {
+        appendDeferred(recorder, data, transferCount * elementSize(transferSize));
+    }
+    else if (type == SDMCallbackId_WriteMemory || type == SDMCallbackId_WriteMemoryAsync) {
+        appendCopy(recorder, data, transferCount * elementSize(transferSize));
+    }
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+}
+
+// Encode the operations and values of a register access. _accesses_ points to SDMRegisterAccessEx elements for
+// registerAccessEx, and to SDMRegisterAccess elements otherwise. _completed_ is the slot returned by
+// completedSlot(), or NULL for an asynchronous request, whose read values are left zero.
+static void recordRegisterAccess(
+    TraceRecorder *recorder,
+    SDMCallbackId type,
+    SDMReturnCode result,
+    uint64_t startNs,
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const void *accesses,
+    size_t accessCount,
+    const size_t *completed,
+    const size_t *accessesCompleted,
+    const size_t *local,
+    const SDMTraceAsyncRequest *async)
+{
+    const size_t offset = beginRecord(recorder, type, result, startNs);
+    if (async != NULL) {
+        appendCopy(recorder, async, sizeof(*async));
+    }
+    SDMTraceRegisterAccess payload;
+    memset(&payload, 0, sizeof(payload));
+    SDMTraceEncodeDevice(device, &payload.device);
+    payload.transferSize = transferSize;
+    payload.accessCount = (uint32_t)accessCount;
+    const size_t payloadOffset = appendCopy(recorder, &payload, sizeof(payload));
+    deferCompleted(recorder, payloadOffset + offsetof(SDMTraceRegisterAccess, accessesCompleted),
+        completed, accessesCompleted, local);
+
+    for (size_t i = 0; i < accessCount; ++i) {
+        SDMTraceRegisterOp op;
+        memset(&op, 0, sizeof(op));
+        op.count = 1;
+        if (type != SDMCallbackId_RegisterAccessEx) {
+            const SDMRegisterAccess *access = &((const SDMRegisterAccess *)accesses)[i];
+            op.address = access->address;
+            op.op = access->op;
+            op.pollMask = access->pollMask;
+            op.retries = access->retries;
+        }
+        else {
+            const SDMRegisterAccessEx *access = &((const SDMRegisterAccessEx *)accesses)[i];
+            op.address = access->address;
+            op.op = access->op;
+            op.flags = access->flags;
+            op.pollMask = access->pollMask;
+            op.pollTimeoutUs = access->pollTimeoutUs;
+            op.pollIntervalUs = access->pollIntervalUs;
+            op.retries = access->retries;
+            if (access->op == SDMRegisterAccessOp_WriteBlock || access->op == SDMRegisterAccessOp_ReadBlock) {
+                op.count = access->count;
+            }
+            op.gateAddress = access->gateAddress;
+            op.gateValue = access->gateValue;
+        }
+        appendCopy(recorder, &op, sizeof(op));
+    }
+
+    for (size_t i = 0; i < accessCount; ++i) {
+        const void *value;
+        SDMRegisterAccessOp op;
+        size_t count = 1;
+        if (type != SDMCallbackId_RegisterAccessEx) {
+            value = ((const SDMRegisterAccess *)accesses)[i].value;
+            op = ((const SDMRegisterAccess *)accesses)[i].op;
+        }
+        else {
+            const SDMRegisterAccessEx *access = &((const SDMRegisterAccessEx *)accesses)[i];
+            value = access->value;
+            op = access->op;
+            if (op == SDMRegisterAccessOp_WriteBlock || op == SDMRegisterAccessOp_ReadBlock) {
+                count = access->count;
+            }
+        }
+        if (async != NULL && op == SDMRegisterAccessOp_Read) {
+            reserve(recorder, elementSize(transferSize));
+        }
+        else if (op == SDMRegisterAccessOp_Read || op == SDMRegisterAccessOp_ReadBlock) {
+            appendDeferred(recorder, value, count * elementSize(transferSize));
+        }
+        else {
+            appendCopy(recorder, value, count * elementSize(transferSize));
+        }
+    }
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+}
+//@}
+
+static TraceRecorder *recorderFor(void *refcon)
+{
+    return (TraceRecorder *)refcon;
+}
+
+//! @name Wrapping callbacks
+//@{
+
+static void updateProgress(const char *progressMessage, uint8_t percentComplete, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    recorder->inner->updateProgress(progressMessage, percentComplete, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_UpdateProgress, 0, start);
+}
+
+static void setErrorMessage(const char *errorMessage, const char *errorDetails, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    recorder->inner->setErrorMessage(errorMessage, errorDetails, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_SetErrorMessage, 0, start);
+}
+
+static SDMReturnCode recordReset(TraceRecorder *recorder, SDMCallbackId type, SDMResetType resetType)
+{
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = type == SDMCallbackId_ResetStart
+        ? recorder->inner->resetStart(resetType, recorder->innerRefcon)
+        : recorder->inner->resetFinish(resetType, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, type, result, start);
+    SDMTraceReset payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.resetType = resetType;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    return result;
+}
+
+static SDMReturnCode resetStart(SDMResetType resetType, void *refcon)
+{
+    return recordReset(recorderFor(refcon), SDMCallbackId_ResetStart, resetType);
+}
+
+static SDMReturnCode resetFinish(SDMResetType resetType, void *refcon)
+{
+    return recordReset(recorderFor(refcon), SDMCallbackId_ResetFinish, resetType);
+}
+
+static SDMReturnCode readMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->readMemory(
+        device, address, transferSize, transferCount, attributes, data, recorder->innerRefcon);
+    recordMemory(recorder, SDMCallbackId_ReadMemory, result, start,
+        device, address, transferSize, transferCount, attributes, data, NULL);
+    return result;
+}
+
+static SDMReturnCode writeMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->writeMemory(
+        device, address, transferSize, transferCount, attributes, value, recorder->innerRefcon);
+    recordMemory(recorder, SDMCallbackId_WriteMemory, result, start,
+        device, address, transferSize, transferCount, attributes, value, NULL);
+    return result;
+}
+
+static SDMReturnCode registerAccess(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    size_t local;
+    size_t *completed = completedSlot(recorder, accessesCompleted, &local);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->registerAccess(
+        device, transferSize, accesses, accessCount, completed, recorder->innerRefcon);
+    recordRegisterAccess(recorder, SDMCallbackId_RegisterAccess, result, start,
+        device, transferSize, accesses, accessCount, completed, accessesCompleted, &local, NULL);
+    return result;
+}
+
+static SDMReturnCode presentForm(const SDMForm *form, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->presentForm(form, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_PresentForm, result, start);
+    return result;
+}
+
+static SDMReturnCode transferMemoryBatch(
+    const SDMMemoryAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    size_t local;
+    size_t *completed = completedSlot(recorder, accessesCompleted, &local);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->transferMemoryBatch(
+        accesses, accessCount, completed, recorder->innerRefcon);
+
+    const size_t offset = beginRecord(recorder, SDMCallbackId_TransferMemoryBatch, result, start);
+    SDMTraceMemoryBatch payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.accessCount = (uint32_t)accessCount;
+    const size_t payloadOffset = appendCopy(recorder, &payload, sizeof(payload));
+    deferCompleted(recorder, payloadOffset + offsetof(SDMTraceMemoryBatch, accessesCompleted),
+        completed, accessesCompleted, &local);
+    for (size_t i = 0; i < accessCount; ++i) {
+        SDMTraceMemoryBatchAccess access;
+        memset(&access, 0, sizeof(access));
+        SDMTraceEncodeDevice(accesses[i].device, &access.device);
+        access.address = accesses[i].address;
+        access.transferSize = accesses[i].transferSize;
+        access.direction = accesses[i].direction;
+        access.transferCount = accesses[i].transferCount;
+        access.attributes = accesses[i].attributes;
+        appendCopy(recorder, &access, sizeof(access));
+    }
+    for (size_t i = 0; i < accessCount; ++i) {
+        const size_t size = accesses[i].transferCount * elementSize(accesses[i].transferSize);
+        if (accesses[i].direction == SDMTransferDirection_Read) {
+            appendDeferred(recorder, accesses[i].data, size);
+        }
+        else {
+            appendCopy(recorder, accesses[i].data, size);
+        }
+    }
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    return result;
+}
+
+// State of a queued asynchronous request, passed as the completion context to the host. Freed by
+// asyncCompletion(), or by the queuing callback if the request was not queued.
+typedef struct TraceAsyncRequest {
+    TraceRecorder *recorder;
+    SDMIOCompletion completion;         // The SDM's completion routine.
+    void *completionContext;            // The SDM's completion context.
+    SDMCallbackId type;
+    uint64_t requestId;
+    uint64_t startNs;
+    SDMTransferSize transferSize;
+    void *data;                         // Read buffer of a memory read.
+    size_t transferCount;
+    const SDMRegisterAccess *accesses;  // Operations of a register access, whose read values are recorded.
+    size_t accessCount;
+} TraceAsyncRequest;
+
+static TraceAsyncRequest *newAsyncRequest(
+    TraceRecorder *recorder,
+    SDMCallbackId type,
+    SDMIOCompletion completion,
+    void *completionContext,
+    uint64_t startNs)
+{
+    TraceAsyncRequest *request = (TraceAsyncRequest *)calloc(1, sizeof(*request));
+    if (request == NULL) {
+        return NULL;
+    }
+    request->recorder = recorder;
+    request->completion = completion;
+    request->completionContext = completionContext;
+    request->type = type;
+    request->startNs = startNs;
+    pthread_mutex_lock(&recorder->lock);
+    request->requestId = ++recorder->requests;
+    pthread_mutex_unlock(&recorder->lock);
+    return request;
+}
+
+// Record the completion of a request, then pass it on to the SDM. May be called on any host thread.
+static void asyncCompletion(SDMRequestToken token, SDMReturnCode result, size_t completedCount, void *context)
+{
+    TraceAsyncRequest *request = (TraceAsyncRequest *)context;
+    TraceRecorder *recorder = request->recorder;
+    const size_t offset = beginRecord(recorder, (SDMCallbackId)SDMTraceRecord_AsyncCompletion, result,
+        request->startNs);
+    if (recorder->error == SDMReturnCode_Success) {
+        // The completion belongs to no transaction group, even if one is open.
+        ((SDMTraceRecordHeader *)(recorder->pending + offset))->flags = 0;
+    }
+    SDMTraceAsyncCompletion payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.requestId = request->requestId;
+    payload.token = token;
+    payload.completedCount = completedCount;
+    payload.callback = request->type;
+    appendCopy(recorder, &payload, sizeof(payload));
+    const size_t size = elementSize(request->transferSize);
+    if (request->type == SDMCallbackId_ReadMemoryAsync) {
+        appendCopy(recorder, request->data, request->transferCount * size);
+    }
+    for (size_t i = 0; i < request->accessCount; ++i) {
+        if (request->accesses[i].op == SDMRegisterAccessOp_Read) {
+            appendCopy(recorder, request->accesses[i].value, size);
+        }
+    }
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+
+    const SDMIOCompletion completion = request->completion;
+    void *completionContext = request->completionContext;
+    free(request);
+    completion(token, result, completedCount, completionContext);
+}
+
+static SDMReturnCode recordMemoryAsync(
+    TraceRecorder *recorder,
+    SDMCallbackId type,
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token)
+{
+    const uint64_t start = traceRecorderNow(recorder);
+    TraceAsyncRequest *request = newAsyncRequest(recorder, type, completion, completionContext, start);
+    if (request == NULL) {
+        return SDMReturnCode_RequestFailed;
+    }
+    request->transferSize = transferSize;
+    request->data = data;
+    request->transferCount = transferCount;
+    SDMTraceAsyncRequest async;
+    memset(&async, 0, sizeof(async));
+    async.requestId = request->requestId;
+    const SDMReturnCode result = type == SDMCallbackId_ReadMemoryAsync
+        ? recorder->inner->readMemoryAsync(device, address, transferSize, transferCount, attributes, data,
+            asyncCompletion, request, token, recorder->innerRefcon)
+        : recorder->inner->writeMemoryAsync(device, address, transferSize, transferCount, attributes, data,
+            asyncCompletion, request, token, recorder->innerRefcon);
+    // Once queued, the request may already have completed and been freed.
+    if (result == SDMReturnCode_Success) {
+        async.token = *token;
+    }
+    else {
+        free(request);
+    }
+    recordMemory(recorder, type, result, start, device, address, transferSize, transferCount, attributes, data,
+        &async);
+    return result;
+}
+
+static SDMReturnCode readMemoryAsync(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    return recordMemoryAsync(recorderFor(refcon), SDMCallbackId_ReadMemoryAsync, device, address, transferSize,
+        transferCount, attributes, data, completion, completionContext, token);
+}
+
+static SDMReturnCode writeMemoryAsync(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    // The host only reads the buffer of a write.
+    return recordMemoryAsync(recorderFor(refcon), SDMCallbackId_WriteMemoryAsync, device, address, transferSize,
+        transferCount, attributes, (void *)value, completion, completionContext, token);
+}
+
+static SDMReturnCode registerAccessAsync(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccess *accesses,
+    size_t accessCount,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    TraceAsyncRequest *request = newAsyncRequest(recorder, SDMCallbackId_RegisterAccessAsync, completion,
+        completionContext, start);
+    if (request == NULL) {
+        return SDMReturnCode_RequestFailed;
+    }
+    request->transferSize = transferSize;
+    request->accesses = accesses;
+    request->accessCount = accessCount;
+    SDMTraceAsyncRequest async;
+    memset(&async, 0, sizeof(async));
+    async.requestId = request->requestId;
+    const SDMReturnCode result = recorder->inner->registerAccessAsync(device, transferSize, accesses, accessCount,
+        asyncCompletion, request, token, recorder->innerRefcon);
+    if (result == SDMReturnCode_Success) {
+        async.token = *token;
+    }
+    else {
+        free(request);
+    }
+    recordRegisterAccess(recorder, SDMCallbackId_RegisterAccessAsync, result, start,
+        device, transferSize, accesses, accessCount, NULL, NULL, NULL, &async);
+    return result;
+}
+
+static SDMReturnCode cancelAsyncRequest(SDMRequestToken token, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->cancelAsyncRequest(token, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_CancelAsyncRequest, result, start);
+    SDMTraceAsyncCancel payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.token = token;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    return result;
+}
+
+static SDMReturnCode registerAccessEx(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccessEx *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    size_t local;
+    size_t *completed = completedSlot(recorder, accessesCompleted, &local);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->registerAccessEx(
+        device, transferSize, accesses, accessCount, completed, recorder->innerRefcon);
+    recordRegisterAccess(recorder, SDMCallbackId_RegisterAccessEx, result, start,
+        device, transferSize, accesses, accessCount, completed, accessesCompleted, &local, NULL);
+    return result;
+}
+
+static SDMReturnCode acquireTransferBuffer(size_t size, void **buffer, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->acquireTransferBuffer(size, buffer, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_AcquireTransferBuffer, result, start);
+    return result;
+}
+
+static void releaseTransferBuffer(void *buffer, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    recorder->inner->releaseTransferBuffer(buffer, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_ReleaseTransferBuffer, 0, start);
+}
+
+static SDMReturnCode loadFormValue(
+    const char *formId,
+    const char *elementId,
+    char *buffer,
+    size_t bufferLength,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->loadFormValue(
+        formId, elementId, buffer, bufferLength, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_LoadFormValue, result, start);
+    return result;
+}
+
+static SDMReturnCode storeFormValue(const char *formId, const char *elementId, const char *value, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->storeFormValue(formId, elementId, value, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_StoreFormValue, result, start);
+    return result;
+}
+
+static void reportProgressEvent(const SDMProgressEvent *event, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    recorder->inner->reportProgressEvent(event, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_ReportProgressEvent, 0, start);
+}
+
+static SDMReturnCode declareMemoryRegion(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    uint64_t size,
+    uint32_t attributes,
+    SDMMemoryRegionKind kind,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->declareMemoryRegion(
+        device, address, size, attributes, kind, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_DeclareMemoryRegion, result, start);
+    return result;
+}
+
+static void invalidateMemoryCache(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    recorder->inner->invalidateMemoryCache(device, address, size, recorder->innerRefcon);
+    recordPlain(recorder, SDMCallbackId_InvalidateMemoryCache, 0, start);
+}
+
+static SDMReturnCode openWriteStream(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    uint32_t attributes,
+    uint64_t totalSize,
+    SDMWriteStream *stream,
+    void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->openWriteStream(
+        device, address, transferSize, attributes, totalSize, stream, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_OpenWriteStream, result, start);
+    SDMTraceWriteStream payload;
+    memset(&payload, 0, sizeof(payload));
+    SDMTraceEncodeDevice(device, &payload.device);
+    payload.address = address;
+    payload.transferSize = transferSize;
+    payload.attributes = attributes;
+    payload.totalSize = totalSize;
+    payload.stream = result == SDMReturnCode_Success ? (uint64_t)(uintptr_t)*stream : 0;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    return result;
+}
+
+static SDMReturnCode writeStreamChunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->writeStreamChunk(stream, data, size, flags, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_WriteStreamChunk, result, start);
+    SDMTraceWriteStreamChunk payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.stream = (uint64_t)(uintptr_t)stream;
+    payload.size = size;
+    payload.flags = flags;
+    appendCopy(recorder, &payload, sizeof(payload));
+    appendCopy(recorder, data, size);
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    return result;
+}
+
+static SDMReturnCode closeWriteStream(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    uint64_t written = 0;
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->closeWriteStream(stream, abort, &written, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_CloseWriteStream, result, start);
+    SDMTraceWriteStreamClose payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.stream = (uint64_t)(uintptr_t)stream;
+    payload.abort = abort ? 1 : 0;
+    payload.bytesWritten = written;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    if (bytesWritten != NULL) {
+        *bytesWritten = written;
+    }
+    return result;
+}
+
+static SDMReturnCode beginTransactionGroup(uint32_t flags, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->beginTransactionGroup(flags, recorder->innerRefcon);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_BeginTransactionGroup, result, start);
+    SDMTraceTransactionGroup payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.flags = flags;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    // Hold the records of the group until the commit, when read data becomes valid.
+    if (result == SDMReturnCode_Success) {
+        recorder->groupActive = true;
+    }
+    flush(recorder);
+    return result;
+}
+
+static SDMReturnCode commitTransactionGroup(size_t *callsCompleted, void *refcon)
+{
+    TraceRecorder *recorder = recorderFor(refcon);
+    size_t completed = 0;
+    const uint64_t start = traceRecorderNow(recorder);
+    const SDMReturnCode result = recorder->inner->commitTransactionGroup(&completed, recorder->innerRefcon);
+    pthread_mutex_lock(&recorder->lock);
+    recorder->groupActive = false;
+    pthread_mutex_unlock(&recorder->lock);
+    const size_t offset = beginRecord(recorder, SDMCallbackId_CommitTransactionGroup, result, start);
+    SDMTraceTransactionGroup payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.callsCompleted = completed;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+    if (callsCompleted != NULL) {
+        *callsCompleted = completed;
+    }
+    return result;
+}
+//@}
+
+SDMReturnCode traceRecorderInit(
+    TraceRecorder *recorder,
+    const char *path,
+    const SDMOpenParameters *params,
+    TraceClock clock,
+    void *clockContext)
+{
+    if (recorder == NULL || path == NULL || params == NULL || params->callbacks == NULL) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->inner = params->callbacks;
+    recorder->innerRefcon = params->refcon;
+    recorder->innerV11 = params->version.major > 1 || (params->version.major == 1 && params->version.minor >= 1);
+    recorder->clock = clock != NULL ? clock : monotonicNs;
+    recorder->clockContext = clockContext;
+    recorder->file = fopen(path, "wb");
+    if (recorder->file == NULL) {
+        return SDMReturnCode_RequestFailed;
+    }
+    pthread_mutex_init(&recorder->lock, NULL);
+
+    SDMTraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SDMTrace_Magic;
+    header.formatVersion = SDMTrace_FormatVersion;
+    header.headerSize = sizeof(header);
+    header.apiMajor = (uint16_t)params->version.major;
+    header.apiMinor = (uint16_t)params->version.minor;
+    header.hostCapabilities = recorder->innerV11 && params->hostCapabilities != NULL
+        ? params->hostCapabilities->flags : 0;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    header.startTimeNs = (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+    if (fwrite(&header, sizeof(header), 1, recorder->file) != 1) {
+        recorder->error = SDMReturnCode_RequestFailed;
+    }
+    recorder->startNs = recorder->clock(recorder->clockContext);
+
+    // The v1.0 members are required. Optional members are wrapped only if the host provides them.
+    const SDMCallbacks *inner = recorder->inner;
+    SDMCallbacks *callbacks = &recorder->callbacks;
+    callbacks->architectureCallbacks = inner->architectureCallbacks;
+    callbacks->updateProgress = updateProgress;
+    callbacks->setErrorMessage = setErrorMessage;
+    callbacks->resetStart = resetStart;
+    callbacks->resetFinish = resetFinish;
+    callbacks->readMemory = readMemory;
+    callbacks->writeMemory = writeMemory;
+    callbacks->registerAccess = registerAccess;
+    callbacks->presentForm = presentForm;
+    if (recorder->innerV11) {
+        callbacks->transferMemoryBatch = inner->transferMemoryBatch != NULL ? transferMemoryBatch : NULL;
+        callbacks->readMemoryAsync = inner->readMemoryAsync != NULL ? readMemoryAsync : NULL;
+        callbacks->writeMemoryAsync = inner->writeMemoryAsync != NULL ? writeMemoryAsync : NULL;
+        callbacks->registerAccessAsync = inner->registerAccessAsync != NULL ? registerAccessAsync : NULL;
+        callbacks->cancelAsyncRequest = inner->cancelAsyncRequest != NULL ? cancelAsyncRequest : NULL;
+        callbacks->registerAccessEx = inner->registerAccessEx != NULL ? registerAccessEx : NULL;
+        callbacks->acquireTransferBuffer = inner->acquireTransferBuffer != NULL ? acquireTransferBuffer : NULL;
+        callbacks->releaseTransferBuffer = inner->releaseTransferBuffer != NULL ? releaseTransferBuffer : NULL;
+        callbacks->loadFormValue = inner->loadFormValue != NULL ? loadFormValue : NULL;
+        callbacks->storeFormValue = inner->storeFormValue != NULL ? storeFormValue : NULL;
+        callbacks->reportProgressEvent = inner->reportProgressEvent != NULL ? reportProgressEvent : NULL;
+        callbacks->declareMemoryRegion = inner->declareMemoryRegion != NULL ? declareMemoryRegion : NULL;
+        callbacks->invalidateMemoryCache = inner->invalidateMemoryCache != NULL ? invalidateMemoryCache : NULL;
+        callbacks->openWriteStream = inner->openWriteStream != NULL ? openWriteStream : NULL;
+        callbacks->writeStreamChunk = inner->writeStreamChunk != NULL ? writeStreamChunk : NULL;
+        callbacks->closeWriteStream = inner->closeWriteStream != NULL ? closeWriteStream : NULL;
+        callbacks->beginTransactionGroup = inner->beginTransactionGroup != NULL ? beginTransactionGroup : NULL;
+        callbacks->commitTransactionGroup = inner->commitTransactionGroup != NULL ? commitTransactionGroup : NULL;
+    }
+    return SDMReturnCode_Success;
+}
+
+uint64_t traceRecorderNow(TraceRecorder *recorder)
+{
+    return recorder->clock(recorder->clockContext) - recorder->startNs;
+}
+
+void traceRecorderApiCall(TraceRecorder *recorder, uint32_t api, SDMReturnCode result, uint64_t startNs)
+{
+    const size_t offset = beginRecord(recorder, (SDMCallbackId)SDMTraceRecord_ApiCall, result, startNs);
+    SDMTraceApiCall payload;
+    memset(&payload, 0, sizeof(payload));
+    payload.api = api;
+    appendCopy(recorder, &payload, sizeof(payload));
+    endRecord(recorder, offset);
+    recorder->records++;
+    flush(recorder);
+}
+
+SDMReturnCode traceRecorderFinish(TraceRecorder *recorder)
+{
+    // Write the records of a group that was never committed.
+    pthread_mutex_lock(&recorder->lock);
+    recorder->groupActive = false;
+    flush(recorder);
+    if (fclose(recorder->file) != 0 && recorder->error == SDMReturnCode_Success) {
+        recorder->error = SDMReturnCode_RequestFailed;
+    }
+    pthread_mutex_destroy(&recorder->lock);
+    free(recorder->pending);
+    free(recorder->fixups);
+    return recorder->error;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @file
+ *
+ * @brief Recording shim that writes an SDM callback trace.
+ *
+ * The recorder wraps a host's #SDMCallbacks table. Each callback made by the SDM through the recorder's table
+ * is forwarded to the host's table, timed, and written to a trace file in the format defined by `sdm_trace.h`.
+ * The recorder adds no callbacks the host does not provide, so the SDM sees the same optional callbacks
+ * whether or not it is being recorded.
+ *
+ * Calls made through one recorder must be serialized, as they are for one SDM handle. Completion routines of
+ * asynchronous requests may run on host threads; the recorder's lock serializes their records with the others.
+ */
+
+#ifndef _TRACE_RECORDER_H_
+#define _TRACE_RECORDER_H_
+
+#include "sdm_trace.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Clock used for record timestamps.
+ *
+ * @return The current time in nanoseconds on a monotonic clock.
+ */
+typedef uint64_t (*TraceClock)(void *context);
+
+/*!
+ * @brief Trace recorder state.
+ */
+typedef struct TraceRecorder {
+    SDMCallbacks callbacks;         //!< Wrapping callback table; pass with this recorder as the refcon.
+    const SDMCallbacks *inner;      //!< Host callback table.
+    void *innerRefcon;              //!< Refcon of the host callback table.
+    SDMBool innerV11;               //!< True if the host callback table has the v1.1 members.
+    FILE *file;                     //!< Trace file.
+    TraceClock clock;               //!< Timestamp clock.
+    void *clockContext;             //!< Context passed to _clock_.
+    uint64_t startNs;               //!< Clock value at the start of the trace.
+    pthread_mutex_t lock;           //!< Protects _file_, the pending records, and _groupActive_.
+    SDMBool groupActive;            //!< True within a transaction group.
+    uint8_t *pending;               //!< Encoded records not yet written.
+    size_t pendingSize;             //!< Size in bytes of _pending_.
+    size_t pendingCapacity;         //!< Allocated size in bytes of _pending_.
+    struct TraceFixup {
+        size_t offset;              //!< Offset within _pending_.
+        const void *source;         //!< SDM buffer to copy from when the records are written.
+        size_t size;                //!< Size in bytes to copy.
+        SDMBool count;              //!< True if _source_ is a size_t count, stored as a uint64_t.
+        void *owned;                //!< Recorder-owned _source_, freed once the records are written, or NULL.
+    } *fixups;                      //!< Read data and counts to copy into _pending_ when they become valid.
+    size_t fixupCount;              //!< Number of fixups.
+    size_t fixupCapacity;           //!< Allocated number of fixups.
+    uint64_t records;               //!< Number of records written.
+    SDMReturnCode error;            //!< First error, set if a record could not be encoded or written.
+    uint64_t requests;              //!< Number of asynchronous requests, used as request identifiers.
+} TraceRecorder;
+
+/*!
+ * @brief Create a trace file and initialise a recorder that wraps a host's callbacks.
+ *
+ * After this call the host passes _callbacks_ and the recorder as the refcon to SDMOpen(), in place of its own
+ * table and refcon.
+ *
+ * @param[out] recorder Recorder to initialise.
+ * @param[in] path Path of the trace file to create.
+ * @param[in] params The host's open parameters. The version, callbacks, refcon, and host capabilities fields
+ *      are used. The callbacks must remain valid until traceRecorderFinish() is called.
+ * @param[in] clock Timestamp clock, or NULL to use CLOCK_MONOTONIC.
+ * @param[in] clockContext Context passed to _clock_.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument
+ * @retval SDMReturnCode_RequestFailed The file could not be created.
+ */
+SDMReturnCode traceRecorderInit(
+    TraceRecorder *recorder,
+    const char *path,
+    const SDMOpenParameters *params,
+    TraceClock clock,
+    void *clockContext);
+
+//! @brief Get the current trace time, for use with traceRecorderApiCall().
+uint64_t traceRecorderNow(TraceRecorder *recorder);
+
+/*!
+ * @brief Record an SDM API call made by the host.
+ *
+ * Call when the API call returns.
+ *
+ * @param[in] recorder Recorder.
+ * @param[in] api The call, one of the #SDMTraceApiEnum enumerators.
+ * @param[in] result Result of the call.
+ * @param[in] startNs Value of traceRecorderNow() when the call was made.
+ */
+void traceRecorderApiCall(TraceRecorder *recorder, uint32_t api, SDMReturnCode result, uint64_t startNs);
+
+/*!
+ * @brief Write any buffered records, close the trace file, and release the recorder's resources.
+ *
+ * @retval SDMReturnCode_Success The whole trace was written.
+ * @return Otherwise, the first error that occurred while recording.
+ */
+SDMReturnCode traceRecorderFinish(TraceRecorder *recorder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACE_RECORDER_H_ */
@@ -0,0 +1,756 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "trace_replay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Position within the record matched against the current call.
+typedef struct ReplayCursor {
+    const SDMTraceRecordHeader *record; //!< The record.
+    const uint8_t *payload;             //!< Remaining payload.
+    size_t size;                        //!< Size in bytes of the remaining payload.
+    size_t next;                        //!< Offset of the following record.
+    uint64_t index;                     //!< Index of the record.
+} ReplayCursor;
+
+static TraceReplay *replayFor(void *refcon)
+{
+    return (TraceReplay *)refcon;
+}
+
+static size_t elementSize(SDMTransferSize transferSize)
+{
+    return transferSize / 8u;
+}
+
+// Records of these callbacks are matched and served; records of other callbacks are skipped.
+static SDMBool isServed(uint32_t type)
+{
+    switch (type) {
+    case SDMCallbackId_ResetStart:
+    case SDMCallbackId_ResetFinish:
+    case SDMCallbackId_ReadMemory:
+    case SDMCallbackId_WriteMemory:
+    case SDMCallbackId_RegisterAccess:
+    case SDMCallbackId_TransferMemoryBatch:
+    case SDMCallbackId_RegisterAccessEx:
+    case SDMCallbackId_BeginTransactionGroup:
+    case SDMCallbackId_CommitTransactionGroup:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static void diverge(TraceReplay *replay, SDMCallbackId callback, uint64_t recordIndex, SDMBool exhausted)
+{
+    if (!replay->diverged) {
+        replay->diverged = true;
+        replay->exhausted = exhausted;
+        replay->divergedRecord = recordIndex;
+        replay->divergedCallback = callback;
+        // The rest of a group whose begin was served goes to the mock, so open the group there too. The
+        // forwarded commit adds the calls already served to the mock's count.
+        if (replay->groupOpen) {
+            replay->groupOpen = false;
+            replay->groupReopened = true;
+            if (replay->mock->beginTransactionGroup != NULL) {
+                replay->mock->beginTransactionGroup(replay->groupFlags, replay->mockRefcon);
+            }
+        }
+    }
+}
+
+// Find the next served record and check that it is of the expected type. Returns false, after marking the
+// replay as diverged, if it is not.
+static SDMBool expect(TraceReplay *replay, SDMCallbackId type, ReplayCursor *cursor)
+{
+    if (replay->diverged) {
+        return false;
+    }
+    size_t offset = replay->offset;
+    uint64_t index = replay->recordIndex;
+    const SDMTraceRecordHeader *record;
+    while ((record = SDMTraceNextRecord(replay->trace, replay->traceSize, &offset)) != NULL
+            && !isServed(record->type)) {
+        index++;
+    }
+    if (record == NULL) {
+        diverge(replay, type, index, true);
+        return false;
+    }
+    if (record->type != type) {
+        diverge(replay, type, index, false);
+        return false;
+    }
+    cursor->record = record;
+    cursor->payload = (const uint8_t *)record + sizeof(SDMTraceRecordHeader);
+    cursor->size = record->size - sizeof(SDMTraceRecordHeader);
+    cursor->next = offset;
+    cursor->index = index;
+    return true;
+}
+
+// Consume the next part of the payload. Returns NULL if the record is too small.
+static const void *take(ReplayCursor *cursor, size_t size)
+{
+    if (cursor->payload == NULL || size > cursor->size) {
+        cursor->payload = NULL;
+        return NULL;
+    }
+    const void *part = cursor->payload;
+    cursor->payload += size;
+    cursor->size -= size;
+    return part;
+}
+
+static void mismatch(TraceReplay *replay, const ReplayCursor *cursor)
+{
+    diverge(replay, cursor->record->type, cursor->index, false);
+}
+
+static SDMReturnCode serve(TraceReplay *replay, const ReplayCursor *cursor)
+{
+    replay->offset = cursor->next;
+    replay->recordIndex = cursor->index + 1;
+    replay->linkNs += cursor->record->durationNs;
+    replay->served++;
+    if (replay->groupOpen) {
+        replay->groupServed++;
+    }
+    return cursor->record->result;
+}
+
+static SDMBool sameDevice(const SDMTraceDevice *recorded, const SDMDeviceDescriptor *device)
+{
+    SDMTraceDevice encoded;
+    SDMTraceEncodeDevice(device, &encoded);
+    return memcmp(recorded, &encoded, sizeof(encoded)) == 0;
+}
+
+//! @name Served callbacks
+//@{
+
+static SDMReturnCode replayReset(TraceReplay *replay, SDMCallbackId type, SDMResetType resetType)
+{
+    ReplayCursor cursor;
+    if (expect(replay, type, &cursor)) {
+        const SDMTraceReset *recorded = (const SDMTraceReset *)take(&cursor, sizeof(SDMTraceReset));
+        if (recorded != NULL && recorded->resetType == resetType) {
+            return serve(replay, &cursor);
+        }
+        mismatch(replay, &cursor);
+    }
+    replay->forwarded++;
+    return type == SDMCallbackId_ResetStart
+        ? replay->mock->resetStart(resetType, replay->mockRefcon)
+        : replay->mock->resetFinish(resetType, replay->mockRefcon);
+}
+
+static SDMReturnCode resetStart(SDMResetType resetType, void *refcon)
+{
+    return replayReset(replayFor(refcon), SDMCallbackId_ResetStart, resetType);
+}
+
+static SDMReturnCode resetFinish(SDMResetType resetType, void *refcon)
+{
+    return replayReset(replayFor(refcon), SDMCallbackId_ResetFinish, resetType);
+}
+
+// Match a memory transfer record. _value_ is the data of a write, compared with the recorded data, or NULL for
+// a read. On success _data_ is the recorded data.
+static SDMBool matchMemory(
+    TraceReplay *replay,
+    SDMCallbackId type,
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    ReplayCursor *cursor,
+    const void **data)
+{
+    if (!expect(replay, type, cursor)) {
+        return false;
+    }
+    const SDMTraceMemory *recorded = (const SDMTraceMemory *)take(cursor, sizeof(SDMTraceMemory));
+    if (recorded != NULL && sameDevice(&recorded->device, device) && recorded->address == address
+            && recorded->transferSize == transferSize && recorded->transferCount == transferCount
+            && recorded->attributes == attributes) {
+        const size_t size = transferCount * elementSize(transferSize);
+        *data = take(cursor, size);
+        if (*data != NULL && (value == NULL || size == 0 || memcmp(*data, value, size) == 0)) {
+            return true;
+        }
+    }
+    mismatch(replay, cursor);
+    return false;
+}
+
+static SDMReturnCode readMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    const void *recorded;
+    if (matchMemory(replay, SDMCallbackId_ReadMemory, device, address, transferSize, transferCount, attributes,
+            NULL, &cursor, &recorded)) {
+        memcpy(data, recorded, transferCount * elementSize(transferSize));
+        return serve(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->readMemory(
+        device, address, transferSize, transferCount, attributes, data, replay->mockRefcon);
+}
+
+static SDMReturnCode writeMemory(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    const void *recorded;
+    if (matchMemory(replay, SDMCallbackId_WriteMemory, device, address, transferSize, transferCount, attributes,
+            value, &cursor, &recorded)) {
+        return serve(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->writeMemory(
+        device, address, transferSize, transferCount, attributes, value, replay->mockRefcon);
+}
+
+// Match a register access record, including its written and polled values, and return the recorded read values.
+// _accesses_ points to either SDMRegisterAccess or SDMRegisterAccessEx elements, selected by _type_.
+static SDMBool matchRegisterAccess(
+    TraceReplay *replay,
+    SDMCallbackId type,
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const void *accesses,
+    size_t accessCount,
+    ReplayCursor *cursor,
+    size_t *accessesCompleted)
+{
+    if (!expect(replay, type, cursor)) {
+        return false;
+    }
+    const SDMTraceRegisterAccess *recorded =
+        (const SDMTraceRegisterAccess *)take(cursor, sizeof(SDMTraceRegisterAccess));
+    if (recorded == NULL || !sameDevice(&recorded->device, device) || recorded->transferSize != transferSize
+            || recorded->accessCount != accessCount) {
+        mismatch(replay, cursor);
+        return false;
+    }
+    const SDMTraceRegisterOp *ops =
+        (const SDMTraceRegisterOp *)take(cursor, accessCount * sizeof(SDMTraceRegisterOp));
+    if (ops == NULL) {
+        mismatch(replay, cursor);
+        return false;
+    }
+    for (size_t i = 0; i < accessCount; ++i) {
+        // Encode the access as the recorder does, so that fields absent from SDMRegisterAccess compare as zero.
+        SDMTraceRegisterOp expected;
+        memset(&expected, 0, sizeof(expected));
+        expected.count = 1;
+        if (type == SDMCallbackId_RegisterAccess) {
+            const SDMRegisterAccess *access = &((const SDMRegisterAccess *)accesses)[i];
+            expected.address = access->address;
+            expected.op = access->op;
+            expected.pollMask = access->pollMask;
+            expected.retries = access->retries;
+        }
+        else {
+            const SDMRegisterAccessEx *access = &((const SDMRegisterAccessEx *)accesses)[i];
+            expected.address = access->address;
+            expected.op = access->op;
+            expected.flags = access->flags;
+            expected.pollMask = access->pollMask;
+            expected.pollTimeoutUs = access->pollTimeoutUs;
+            expected.pollIntervalUs = access->pollIntervalUs;
+            expected.retries = access->retries;
+            if (access->op == SDMRegisterAccessOp_WriteBlock || access->op == SDMRegisterAccessOp_ReadBlock) {
+                expected.count = access->count;
+            }
+            expected.gateAddress = access->gateAddress;
+            expected.gateValue = access->gateValue;
+        }
+        if (ops[i].address != expected.address || ops[i].op != expected.op || ops[i].flags != expected.flags
+                || ops[i].count != expected.count || ops[i].pollMask != expected.pollMask
+                || ops[i].pollTimeoutUs != expected.pollTimeoutUs || ops[i].pollIntervalUs != expected.pollIntervalUs
+                || ops[i].retries != expected.retries || ops[i].gateAddress != expected.gateAddress
+                || ops[i].gateValue != expected.gateValue) {
+            mismatch(replay, cursor);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < accessCount; ++i) {
+        const size_t size = (size_t)ops[i].count * elementSize(transferSize);
+        const void *values = take(cursor, size);
+        if (values == NULL) {
+            mismatch(replay, cursor);
+            return false;
+        }
+        void *value = type == SDMCallbackId_RegisterAccess
+            ? (void *)((const SDMRegisterAccess *)accesses)[i].value
+            : ((const SDMRegisterAccessEx *)accesses)[i].value;
+        if (ops[i].op == SDMRegisterAccessOp_Read || ops[i].op == SDMRegisterAccessOp_ReadBlock) {
+            memcpy(value, values, size);
+        }
+        else if (size != 0 && memcmp(value, values, size) != 0) {
+            // A written value or poll match value differs from the recorded one.
+            mismatch(replay, cursor);
+            return false;
+        }
+    }
+    if (accessesCompleted != NULL) {
+        *accessesCompleted = (size_t)recorded->accessesCompleted;
+    }
+    return true;
+}
+
+static SDMReturnCode registerAccess(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    if (matchRegisterAccess(replay, SDMCallbackId_RegisterAccess, device, transferSize, accesses, accessCount,
+            &cursor, accessesCompleted)) {
+        return serve(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->registerAccess(
+        device, transferSize, accesses, accessCount, accessesCompleted, replay->mockRefcon);
+}
+
+static SDMReturnCode registerAccessEx(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccessEx *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    if (matchRegisterAccess(replay, SDMCallbackId_RegisterAccessEx, device, transferSize, accesses, accessCount,
+            &cursor, accessesCompleted)) {
+        return serve(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->registerAccessEx(
+        device, transferSize, accesses, accessCount, accessesCompleted, replay->mockRefcon);
+}
+
+static SDMBool matchMemoryBatch(
+    TraceReplay *replay,
+    const SDMMemoryAccess *accesses,
+    size_t accessCount,
+    ReplayCursor *cursor,
+    size_t *accessesCompleted)
+{
+    if (!expect(replay, SDMCallbackId_TransferMemoryBatch, cursor)) {
+        return false;
+    }
+    const SDMTraceMemoryBatch *recorded = (const SDMTraceMemoryBatch *)take(cursor, sizeof(SDMTraceMemoryBatch));
+    const SDMTraceMemoryBatchAccess *transfers = recorded != NULL && recorded->accessCount == accessCount
+        ? (const SDMTraceMemoryBatchAccess *)take(cursor, accessCount * sizeof(SDMTraceMemoryBatchAccess))
+        : NULL;
+    if (transfers == NULL) {
+        mismatch(replay, cursor);
+        return false;
+    }
+    for (size_t i = 0; i < accessCount; ++i) {
+        if (!sameDevice(&transfers[i].device, accesses[i].device) || transfers[i].address != accesses[i].address
+                || transfers[i].transferSize != accesses[i].transferSize
+                || transfers[i].direction != accesses[i].direction
+                || transfers[i].transferCount != accesses[i].transferCount
+                || transfers[i].attributes != accesses[i].attributes) {
+            mismatch(replay, cursor);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < accessCount; ++i) {
+        const size_t size = accesses[i].transferCount * elementSize(accesses[i].transferSize);
+        const void *data = take(cursor, size);
+        if (data == NULL || (accesses[i].direction != SDMTransferDirection_Read && size != 0
+                && memcmp(data, accesses[i].data, size) != 0)) {
+            mismatch(replay, cursor);
+            return false;
+        }
+        if (accesses[i].direction == SDMTransferDirection_Read) {
+            memcpy(accesses[i].data, data, size);
+        }
+    }
+    if (accessesCompleted != NULL) {
+        *accessesCompleted = (size_t)recorded->accessesCompleted;
+    }
+    return true;
+}
+
+static SDMReturnCode transferMemoryBatch(
+    const SDMMemoryAccess *accesses,
+    size_t accessCount,
+    size_t *accessesCompleted,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    if (matchMemoryBatch(replay, accesses, accessCount, &cursor, accessesCompleted)) {
+        return serve(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->transferMemoryBatch(accesses, accessCount, accessesCompleted, replay->mockRefcon);
+}
+
+static SDMReturnCode beginTransactionGroup(uint32_t flags, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    if (expect(replay, SDMCallbackId_BeginTransactionGroup, &cursor)) {
+        const SDMTraceTransactionGroup *recorded =
+            (const SDMTraceTransactionGroup *)take(&cursor, sizeof(SDMTraceTransactionGroup));
+        if (recorded != NULL && recorded->flags == flags) {
+            const SDMReturnCode result = serve(replay, &cursor);
+            replay->groupOpen = result == SDMReturnCode_Success;
+            replay->groupFlags = flags;
+            replay->groupServed = 0;
+            return result;
+        }
+        mismatch(replay, &cursor);
+    }
+    replay->forwarded++;
+    return replay->mock->beginTransactionGroup(flags, replay->mockRefcon);
+}
+
+static SDMReturnCode commitTransactionGroup(size_t *callsCompleted, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    ReplayCursor cursor;
+    if (expect(replay, SDMCallbackId_CommitTransactionGroup, &cursor)) {
+        const SDMTraceTransactionGroup *recorded =
+            (const SDMTraceTransactionGroup *)take(&cursor, sizeof(SDMTraceTransactionGroup));
+        if (recorded != NULL) {
+            if (callsCompleted != NULL) {
+                *callsCompleted = (size_t)recorded->callsCompleted;
+            }
+            replay->groupOpen = false;
+            return serve(replay, &cursor);
+        }
+        mismatch(replay, &cursor);
+    }
+    replay->forwarded++;
+    size_t completed = 0;
+    const SDMReturnCode result = replay->mock->commitTransactionGroup(&completed, replay->mockRefcon);
+    if (replay->groupReopened) {
+        // Served calls precede the forwarded ones, and were served with their recorded success.
+        completed += replay->groupServed;
+        replay->groupReopened = false;
+    }
+    if (callsCompleted != NULL) {
+        *callsCompleted = completed;
+    }
+    return result;
+}
+//@}
+
+//! @name Forwarded callbacks
+//@{
+
+static void updateProgress(const char *progressMessage, uint8_t percentComplete, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    replay->mock->updateProgress(progressMessage, percentComplete, replay->mockRefcon);
+}
+
+static void setErrorMessage(const char *errorMessage, const char *errorDetails, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    replay->mock->setErrorMessage(errorMessage, errorDetails, replay->mockRefcon);
+}
+
+static SDMReturnCode presentForm(const SDMForm *form, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->presentForm(form, replay->mockRefcon);
+}
+
+static SDMReturnCode readMemoryAsync(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    void *data,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->readMemoryAsync(device, address, transferSize, transferCount, attributes, data,
+        completion, completionContext, token, replay->mockRefcon);
+}
+
+static SDMReturnCode writeMemoryAsync(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    size_t transferCount,
+    uint32_t attributes,
+    const void *value,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->writeMemoryAsync(device, address, transferSize, transferCount, attributes, value,
+        completion, completionContext, token, replay->mockRefcon);
+}
+
+static SDMReturnCode registerAccessAsync(
+    const SDMDeviceDescriptor *device,
+    SDMTransferSize transferSize,
+    const SDMRegisterAccess *accesses,
+    size_t accessCount,
+    SDMIOCompletion completion,
+    void *completionContext,
+    SDMRequestToken *token,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->registerAccessAsync(device, transferSize, accesses, accessCount,
+        completion, completionContext, token, replay->mockRefcon);
+}
+
+static SDMReturnCode cancelAsyncRequest(SDMRequestToken token, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->cancelAsyncRequest(token, replay->mockRefcon);
+}
+
+static SDMReturnCode acquireTransferBuffer(size_t size, void **buffer, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->acquireTransferBuffer(size, buffer, replay->mockRefcon);
+}
+
+static void releaseTransferBuffer(void *buffer, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    replay->mock->releaseTransferBuffer(buffer, replay->mockRefcon);
+}
+
+static SDMReturnCode loadFormValue(
+    const char *formId,
+    const char *elementId,
+    char *buffer,
+    size_t bufferLength,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->loadFormValue(formId, elementId, buffer, bufferLength, replay->mockRefcon);
+}
+
+static SDMReturnCode storeFormValue(const char *formId, const char *elementId, const char *value, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->storeFormValue(formId, elementId, value, replay->mockRefcon);
+}
+
+static void reportProgressEvent(const SDMProgressEvent *event, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    replay->mock->reportProgressEvent(event, replay->mockRefcon);
+}
+
+static SDMReturnCode declareMemoryRegion(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    uint64_t size,
+    uint32_t attributes,
+    SDMMemoryRegionKind kind,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->declareMemoryRegion(device, address, size, attributes, kind, replay->mockRefcon);
+}
+
+static void invalidateMemoryCache(const SDMDeviceDescriptor *device, uint64_t address, uint64_t size, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    replay->mock->invalidateMemoryCache(device, address, size, replay->mockRefcon);
+}
+
+static SDMReturnCode openWriteStream(
+    const SDMDeviceDescriptor *device,
+    uint64_t address,
+    SDMTransferSize transferSize,
+    uint32_t attributes,
+    uint64_t totalSize,
+    SDMWriteStream *stream,
+    void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->openWriteStream(
+        device, address, transferSize, attributes, totalSize, stream, replay->mockRefcon);
+}
+
+static SDMReturnCode writeStreamChunk(SDMWriteStream stream, const void *data, size_t size, uint32_t flags, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->writeStreamChunk(stream, data, size, flags, replay->mockRefcon);
+}
+
+static SDMReturnCode closeWriteStream(SDMWriteStream stream, SDMBool abort, uint64_t *bytesWritten, void *refcon)
+{
+    TraceReplay *replay = replayFor(refcon);
+    replay->forwarded++;
+    return replay->mock->closeWriteStream(stream, abort, bytesWritten, replay->mockRefcon);
+}
+//@}
+
+SDMReturnCode traceReplayInit(TraceReplay *replay, const char *path, const SDMCallbacks *mock, void *mockRefcon)
+{
+    if (replay == NULL || path == NULL || mock == NULL) {
+        return SDMReturnCode_InvalidArgument;
+    }
+    memset(replay, 0, sizeof(*replay));
+    replay->mock = mock;
+    replay->mockRefcon = mockRefcon;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return SDMReturnCode_RequestFailed;
+    }
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        size = ftell(file);
+    }
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return SDMReturnCode_RequestFailed;
+    }
+    replay->traceSize = (size_t)size;
+    // malloc() returns memory aligned for any object, which satisfies the trace's 8-byte alignment.
+    replay->trace = (uint8_t *)malloc(replay->traceSize != 0 ? replay->traceSize : 1);
+    if (replay->trace == NULL) {
+        fclose(file);
+        return SDMReturnCode_InternalError;
+    }
+    const size_t read = fread(replay->trace, 1, replay->traceSize, file);
+    fclose(file);
+    if (read != replay->traceSize) {
+        traceReplayDestroy(replay);
+        return SDMReturnCode_RequestFailed;
+    }
+    const SDMTraceFileHeader *header = SDMTraceCheck(replay->trace, replay->traceSize);
+    if (header == NULL) {
+        traceReplayDestroy(replay);
+        return SDMReturnCode_InvalidArgument;
+    }
+    replay->offset = header->headerSize;
+
+    // Offer the callbacks the mock offers, so that the SDM selects the same ones as against the mock.
+    SDMCallbacks *callbacks = &replay->callbacks;
+    callbacks->architectureCallbacks = mock->architectureCallbacks;
+    callbacks->updateProgress = updateProgress;
+    callbacks->setErrorMessage = setErrorMessage;
+    callbacks->resetStart = resetStart;
+    callbacks->resetFinish = resetFinish;
+    callbacks->readMemory = readMemory;
+    callbacks->writeMemory = writeMemory;
+    callbacks->registerAccess = registerAccess;
+    callbacks->presentForm = presentForm;
+    callbacks->transferMemoryBatch = mock->transferMemoryBatch != NULL ? transferMemoryBatch : NULL;
+    callbacks->readMemoryAsync = mock->readMemoryAsync != NULL ? readMemoryAsync : NULL;
+    callbacks->writeMemoryAsync = mock->writeMemoryAsync != NULL ? writeMemoryAsync : NULL;
+    callbacks->registerAccessAsync = mock->registerAccessAsync != NULL ? registerAccessAsync : NULL;
+    callbacks->cancelAsyncRequest = mock->cancelAsyncRequest != NULL ? cancelAsyncRequest : NULL;
+    callbacks->registerAccessEx = mock->registerAccessEx != NULL ? registerAccessEx : NULL;
+    callbacks->acquireTransferBuffer = mock->acquireTransferBuffer != NULL ? acquireTransferBuffer : NULL;
+    callbacks->releaseTransferBuffer = mock->releaseTransferBuffer != NULL ? releaseTransferBuffer : NULL;
+    callbacks->loadFormValue = mock->loadFormValue != NULL ? loadFormValue : NULL;
+    callbacks->storeFormValue = mock->storeFormValue != NULL ? storeFormValue : NULL;
+    callbacks->reportProgressEvent = mock->reportProgressEvent != NULL ? reportProgressEvent : NULL;
+    callbacks->declareMemoryRegion = mock->declareMemoryRegion != NULL ? declareMemoryRegion : NULL;
+    callbacks->invalidateMemoryCache = mock->invalidateMemoryCache != NULL ? invalidateMemoryCache : NULL;
+    callbacks->openWriteStream = mock->openWriteStream != NULL ? openWriteStream : NULL;
+    callbacks->writeStreamChunk = mock->writeStreamChunk != NULL ? writeStreamChunk : NULL;
+    callbacks->closeWriteStream = mock->closeWriteStream != NULL ? closeWriteStream : NULL;
+    callbacks->beginTransactionGroup = mock->beginTransactionGroup != NULL ? beginTransactionGroup : NULL;
+    callbacks->commitTransactionGroup = mock->commitTransactionGroup != NULL ? commitTransactionGroup : NULL;
+    return SDMReturnCode_Success;
+}
+
+void traceReplayDestroy(TraceReplay *replay)
+{
+    free(replay->trace);
+    replay->trace = NULL;
+    replay->traceSize = 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2020-2022 Arm Ltd
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * o Redistributions of source code must retain the above copyright notice, this list
+ *   of conditions and the following disclaimer.
+ *
+ * o Redistributions in binary form must reproduce the above copyright notice, this
+ *   list of conditions and the following disclaimer in the documentation and/or
+ *   other materials provided with the distribution.
+ *
+ * o Neither the name of the copyright holder nor the names of its contributors may
+ *   be used to endorse or promote products derived from this software without
+ *   specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*!
+ * @file
+ *
+ * @brief Replay driver that serves SDM callbacks from a recorded trace.
+ *
+ * The replay driver provides an #SDMCallbacks table that answers the SDM's link traffic from a trace written
+ * by the recorder in `trace_recorder.h`. Reset, memory, register access, memory batch, and transaction group
+ * calls are matched in order against the trace records of the same callbacks. For each call that matches, the
+ * recorded read data, completion counts, and result are returned at once, and the recorded duration is added
+ * to a replay clock. Other callbacks, such as progress, form, asynchronous I/O, and write stream callbacks, are
+ * forwarded to a mock table, typically the simulated link of the benchmark harness.
+ *
+ * A call matches if it is of the recorded type and has the recorded device, address, transfer size, count,
+ * register operations, poll masks and match values, and written data. A protocol that writes different data on
+ * each run, for instance a fresh nonce, therefore diverges at its first such write. At the first call that does
+ * not match, or once the trace is exhausted, the replay diverges: that call and all later calls are forwarded to
+ * the mock table. If the replay diverges within a transaction group whose begin was served, the group is begun
+ * on the mock table with the recorded flags, and the forwarded commit counts the calls already served.
+ */
+
+#ifndef _TRACE_REPLAY_H_
+#define _TRACE_REPLAY_H_
+
+#include "sdm_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * @brief Replay driver state.
+ */
+typedef struct TraceReplay {
+    SDMCallbacks callbacks;         //!< Replay callback table; pass with this replay as the refcon.
+    const SDMCallbacks *mock;       //!< Table for callbacks not served from the trace. Must be a v1.1 table.
+    void *mockRefcon;               //!< Refcon of the mock table.
+    uint8_t *trace;                 //!< Trace contents.
+    size_t traceSize;               //!< Size in bytes of the trace.
+    size_t offset;                  //!< Offset of the record after the last one served.
+    uint64_t recordIndex;           //!< Index of the record after the last one served.
+    uint64_t linkNs;                //!< Sum of the recorded durations of the calls served.
+    uint64_t served;                //!< Number of calls served from the trace.
+    uint64_t forwarded;             //!< Number of calls forwarded to the mock table.
+    SDMBool diverged;               //!< True once a call has not matched the trace.
+    SDMBool exhausted;              //!< True if the replay diverged because the trace ended.
+    uint64_t divergedRecord;        //!< Index of the first record that did not match.
+    SDMCallbackId divergedCallback; //!< Callback that did not match.
+    SDMBool groupOpen;              //!< True within a transaction group whose begin was served.
+    uint32_t groupFlags;            //!< Flags of the open served group.
+    size_t groupServed;             //!< Calls served within the open group.
+    SDMBool groupReopened;          //!< True if the open group was begun on the mock when the replay diverged.
+} TraceReplay;
+
+/*!
+ * @brief Load a trace and initialise a replay driver.
+ *
+ * @param[out] replay Replay driver to initialise.
+ * @param[in] path Path of the trace file.
+ * @param[in] mock Table for callbacks not served from the trace. Must remain valid while the replay is used.
+ * @param[in] mockRefcon Refcon of the mock table.
+ *
+ * @retval SDMReturnCode_Success
+ * @retval SDMReturnCode_InvalidArgument The file is not a trace of a supported format version.
+ * @retval SDMReturnCode_RequestFailed The file could not be read.
+ * @retval SDMReturnCode_InternalError
+ */
+SDMReturnCode traceReplayInit(TraceReplay *replay, const char *path, const SDMCallbacks *mock, void *mockRefcon);
+
+//! @brief Release resources held by a replay driver.
+void traceReplayDestroy(TraceReplay *replay);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACE_REPLAY_H_ */